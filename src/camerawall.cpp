@@ -1,4 +1,9 @@
 #include "camerawall.h"
+#include "framepool.h"
+#include "reconnectscheduler.h"
+#include "streamwatchdog.h"
+#include "streamhub.h"
+#include "qualityscheduler.h"
 #include <QMenuBar>
 #include <QMenu>
 #include <QStatusBar>
@@ -9,9 +14,36 @@
 #include <QApplication>
 #include <QKeyEvent> // + ESC kezelés
 #include <QShortcut> // + ESC gyorsbillentyű
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QSpinBox>
+#include <algorithm>
+#include <QWindow>
+
+#ifdef Q_OS_WIN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <wtsapi32.h>
 
 namespace
 {
+    // GUID_CONSOLE_DISPLAY_STATE: kijelző ki / be / halványítva (initguid nélkül is elérhető)
+    const GUID kConsoleDisplayState = {0x6fe69556, 0x704a, 0x47a0, {0x8f, 0x24, 0xc2, 0x8d, 0x93, 0x6f, 0xda, 0x47}};
+}
+#endif
+
+namespace
+{
+    // a folyamat falai (több képernyős mód): a közös kameralista változásáról értesülnek
+    QList<CameraWall *> &openWalls()
+    {
+        static QList<CameraWall *> walls;
+        return walls;
+    }
+
     QIcon loadAppIcon()
     {
         QIcon ico(":/icons/res/app.ico");
@@ -20,10 +52,70 @@ namespace
         QIcon png(":/icons/res/app_256.png");
         return png;
     }
+
+    QString aspectToStr(VideoTile::AspectMode m)
+    {
+        switch (m)
+        {
+        case VideoTile::AspectMode::Stretch:
+            return "stretch";
+        case VideoTile::AspectMode::Fill:
+            return "fill";
+        case VideoTile::AspectMode::Fit:
+        default:
+            return "fit";
+        }
+    }
+
+    // egy kamera beállításai az aktuális (CameraN) csoportba
+    void writeCameraSettings(QSettings &s, const Camera &c)
+    {
+        s.setValue("name", c.name);
+        s.setValue("mode", c.mode == Camera::ONVIF ? "onvif" : "rtsp");
+        if (c.mode == Camera::RTSP)
+        {
+            s.setValue("rtsp", QString::fromUtf8(c.rtspManual.toEncoded()));
+            s.setValue("rtsp_high", QString::fromUtf8(c.rtspManualHigh.toEncoded()));
+        }
+        else
+        {
+            s.setValue("onvif_device_xaddr", c.onvifDeviceXAddr.toString());
+            s.setValue("onvif_media_xaddr", c.onvifMediaXAddr.toString());
+            s.setValue("onvif_user", c.onvifUser);
+            s.setValue("onvif_pass", c.onvifPass);
+            s.setValue("onvif_token", c.onvifChosenToken);
+            s.setValue("onvif_token_high", c.onvifHighToken);
+            s.setValue("rtsp_cached", c.rtspUriCached);
+            s.setValue("rtsp_cached_high", c.rtspUriCachedHigh);
+            s.setValue("rtsp_cached_at", c.uriValidatedAt.toString(Qt::ISODate));
+            s.setValue("onvif_auto", c.onvifAutoProfile);
+            s.beginWriteArray("profiles", c.onvifProfiles.size());
+            for (int k = 0; k < c.onvifProfiles.size(); ++k)
+            {
+                const OnvifProfile &p = c.onvifProfiles[k];
+                s.setArrayIndex(k);
+                s.setValue("token", p.token);
+                s.setValue("name", p.name);
+                s.setValue("encoding", p.encoding);
+                s.setValue("width", p.resolution.width());
+                s.setValue("height", p.resolution.height());
+            }
+            s.endArray();
+        }
+
+        // --- Aspect mód mentése ---
+        s.setValue("aspect", aspectToStr(c.aspectMode));
+        s.setValue("aspectRtsp", aspectToStr(c.aspectModeRtsp));
+        s.setValue("maxFps", c.maxFps);
+        s.setValue("backend", c.backend == StreamSource::LibAv ? "libav" : "qt");
+        s.setValue("av_options", c.avOptions);
+    }
 }
 
-CameraWall::CameraWall()
+CameraWall::CameraWall(int wallIndex)
+    : m_wallIndex(qMax(0, wallIndex))
 {
+    openWalls() << this;
     setWindowIcon(loadAppIcon());
     updateAppTitle();
 
@@ -76,6 +168,10 @@ CameraWall::CameraWall()
     mCams->addSeparator();
     actReorder = mCams->addAction({}, this, &CameraWall::onReorder);
     actReload = mCams->addAction({}, this, &CameraWall::reloadAll);
+    // további falak: saját kameralista (a közös [Cameras] csoportot csak az első fal írja)
+    actOwnCameras = mCams->addAction({}, this, &CameraWall::setOwnCameraList);
+    actOwnCameras->setCheckable(true);
+    actOwnCameras->setVisible(m_wallIndex > 0);
     mCams->addSeparator();
     actExit = mCams->addAction({}, this, [this]
                                {
@@ -98,26 +194,47 @@ CameraWall::CameraWall()
     actStatusbar = mView->addAction({}, this, &CameraWall::toggleStatusbarVisible);
     actStatusbar->setCheckable(true);
 
-    // Grid menü (ÚJ: 3×2 is)
+    // Grid menü: gyakori méretek + tetszőleges oszlop × sor
     mGridMenu = new QMenu(mView);
     mView->addMenu(mGridMenu);
 
     gridGroup = new QActionGroup(mGridMenu);
     gridGroup->setExclusive(true);
-    actGrid22 = mGridMenu->addAction("2×2");
-    actGrid33 = mGridMenu->addAction("3×3");
-    actGrid32 = mGridMenu->addAction("3×2");
-    for (auto *a : {actGrid22, actGrid33, actGrid32})
+    const QList<QSize> presets = {{2, 2}, {3, 2}, {3, 3}, {4, 3}, {4, 4}, {6, 6}, {8, 8}}; // oszlop × sor
+    for (const QSize &g : presets)
+    {
+        QAction *a = mGridMenu->addAction(QString("%1×%2").arg(g.width()).arg(g.height()));
         a->setCheckable(true);
-    gridGroup->addAction(actGrid22);
-    gridGroup->addAction(actGrid33);
-    gridGroup->addAction(actGrid32);
-    connect(actGrid22, &QAction::triggered, this, [this]
-            { setGridN(22); });
-    connect(actGrid33, &QAction::triggered, this, [this]
-            { setGridN(33); });
-    connect(actGrid32, &QAction::triggered, this, [this]
-            { setGridN(32); });
+        a->setData(g);
+        gridGroup->addAction(a);
+        connect(a, &QAction::triggered, this, [this, g]
+                { setGrid(g.width(), g.height()); });
+        gridPresetActions << a;
+    }
+    mGridMenu->addSeparator();
+    actGridCustom = mGridMenu->addAction({}, this, &CameraWall::onCustomGrid);
+    actGridCustom->setCheckable(true);
+    gridGroup->addAction(actGridCustom);
+
+    // Újrarajzolás üteme: a csempék frame-jei egy ütemben, együtt festődnek
+    mRepaintMenu = new QMenu(mView);
+    mView->addMenu(mRepaintMenu);
+    repaintGroup = new QActionGroup(mRepaintMenu);
+    repaintGroup->setExclusive(true);
+    actRepaintNow = mRepaintMenu->addAction({});
+    actRepaint30 = mRepaintMenu->addAction("30 Hz");
+    actRepaint60 = mRepaintMenu->addAction("60 Hz");
+    for (auto *a : {actRepaintNow, actRepaint30, actRepaint60})
+    {
+        a->setCheckable(true);
+        repaintGroup->addAction(a);
+    }
+    connect(actRepaintNow, &QAction::triggered, this, [this]
+            { setRepaintRate(0); });
+    connect(actRepaint30, &QAction::triggered, this, [this]
+            { setRepaintRate(30); });
+    connect(actRepaint60, &QAction::triggered, this, [this]
+            { setRepaintRate(60); });
 
     // Súgó + Nyelv (változatlan)
     mHelp = new QMenu(this);
@@ -126,6 +243,7 @@ CameraWall::CameraWall()
     mHelp->addMenu(menuLanguage);
     actBackground = mHelp->addAction({}, this, &CameraWall::chooseBackgroundImage);
     actBackgroundClear = mHelp->addAction({}, this, &CameraWall::clearBackgroundImage);
+    actStats = mHelp->addAction({}, this, &CameraWall::showStreamStats);
     langGroup = new QActionGroup(menuLanguage);
     langGroup->setExclusive(true);
     actLangHu = menuLanguage->addAction("Magyar");
@@ -171,11 +289,45 @@ CameraWall::CameraWall()
     connect(&rotateTimer, &QTimer::timeout, this, &CameraWall::nextPage);
     rotateTimer.setInterval(10000);
 
+    // előre kapcsolás / dupla pufferelt lapozás
+    preconnectTimer.setSingleShot(true);
+    connect(&preconnectTimer, &QTimer::timeout, this, [this]
+            { preconnectPage((currentPage + 1) % pageCount()); });
+    flipDeadline.setSingleShot(true);
+    flipDeadline.setInterval(5000); // ennyinél tovább nem várunk a lassú kamerákra
+    connect(&flipDeadline, &QTimer::timeout, this, [this]
+            {
+        if (m_pendingPage >= 0)
+            showPage(m_pendingPage); });
+
+    // láthatatlan fal: a konverzió azonnal áll, a dekódolás (ha beállítva) csak türelmi idő után
+    hiddenStopTimer.setSingleShot(true);
+    connect(&hiddenStopTimer, &QTimer::timeout, this, [this]
+            {
+        m_hiddenDecodeStopped = true;
+        applySuspendPolicy(); });
+    connect(qApp, &QGuiApplication::applicationStateChanged, this, [this](Qt::ApplicationState st)
+            { setHiddenReason(HiddenAppHidden, st == Qt::ApplicationHidden || st == Qt::ApplicationSuspended); });
+
+    profileTimer.setSingleShot(true);
+    profileTimer.setInterval(600);
+    connect(&profileTimer, &QTimer::timeout, this, &CameraWall::reevaluateAutoProfiles);
+
+    // ONVIF stream-címek időszakos ellenőrzése (csak a lejárt TTL-űek, a háttérben)
+    uriRevalidateTimer.setInterval(10 * 60 * 1000);
+    connect(&uriRevalidateTimer, &QTimer::timeout, this, &CameraWall::revalidateStaleUris);
+    uriRevalidateTimer.start();
+
+    compositor = new WallCompositor(this);
+
     // beállítások
     loadFromIni();
+    compositor->setRate(m_repaintHz);
     // jelöld ki a megfelelő rácsot
     updateGridChecks();
+    updateRepaintChecks();
     actFps->setChecked(m_limitFps15);
+    actOwnCameras->setChecked(ownsCameraList());
     actAutoRotate->setChecked(m_autoRotate);
     actKeepAlive->setChecked(m_keepBackgroundStreams);
 
@@ -228,9 +380,9 @@ void CameraWall::contextMenuEvent(QContextMenuEvent *e)
     menu.addSeparator();
     menu.addAction(Language::instance().t("menu.fullscreen", "Fullscreen (window)"), this, &CameraWall::toggleFullscreen);
     QMenu *sub = menu.addMenu(Language::instance().t("menu.grid", "Grid"));
-    sub->addAction(actGrid22);
-    sub->addAction(actGrid32);
-    sub->addAction(actGrid33);
+    sub->addActions(gridPresetActions);
+    sub->addSeparator();
+    sub->addAction(actGridCustom);
     menu.addAction(Language::instance().t("menu.reorder", "Reorder cameras…"), this, &CameraWall::onReorder);
     menu.exec(e->globalPos());
 }
@@ -261,11 +413,114 @@ void CameraWall::keyPressEvent(QKeyEvent *e)
     QMainWindow::keyPressEvent(e);
 }
 
+CameraWall::~CameraWall()
+{
+    openWalls().removeAll(this);
+#ifdef Q_OS_WIN
+    if (m_visibilityHooked && internalWinId())
+    {
+        const HWND hwnd = reinterpret_cast<HWND>(internalWinId());
+        WTSUnRegisterSessionNotification(hwnd);
+        if (m_powerNotify)
+            UnregisterPowerSettingNotification(HPOWERNOTIFY(m_powerNotify));
+    }
+#endif
+}
+
+void CameraWall::changeEvent(QEvent *e)
+{
+    QMainWindow::changeEvent(e);
+    if (e->type() == QEvent::WindowStateChange)
+        setHiddenReason(HiddenMinimized, isMinimized());
+}
+
+void CameraWall::showEvent(QShowEvent *e)
+{
+    QMainWindow::showEvent(e);
+    registerVisibilityNotifications(); // a natív ablak itt már biztosan létezik
+}
+
+bool CameraWall::eventFilter(QObject *obj, QEvent *e)
+{
+    // teljes takarás / nem kirajzolható ablak (platformfüggő: pl. macOS, Wayland jelzi)
+    if (obj == windowHandle() && e->type() == QEvent::Expose)
+        setHiddenReason(HiddenNotExposed, !windowHandle()->isExposed());
+    return QMainWindow::eventFilter(obj, e);
+}
+
+#ifdef Q_OS_WIN
+bool CameraWall::nativeEvent(const QByteArray &eventType, void *message, qintptr *result)
+{
+    const MSG *msg = static_cast<const MSG *>(message);
+    if (msg->message == WM_WTSSESSION_CHANGE)
+    {
+        if (msg->wParam == WTS_SESSION_LOCK)
+            setHiddenReason(HiddenSessionLocked, true);
+        else if (msg->wParam == WTS_SESSION_UNLOCK)
+            setHiddenReason(HiddenSessionLocked, false);
+    }
+    else if (msg->message == WM_POWERBROADCAST && msg->wParam == PBT_POWERSETTINGCHANGE)
+    {
+        const auto *pbs = reinterpret_cast<const POWERBROADCAST_SETTING *>(msg->lParam);
+        if (pbs && IsEqualGUID(pbs->PowerSetting, kConsoleDisplayState) && pbs->DataLength >= sizeof(DWORD))
+        {
+            const DWORD state = *reinterpret_cast<const DWORD *>(pbs->Data); // 0 = ki, 1 = be, 2 = halványítva
+            setHiddenReason(HiddenDisplayOff, state == 0);
+        }
+    }
+    return QMainWindow::nativeEvent(eventType, message, result);
+}
+#endif
+
+void CameraWall::registerVisibilityNotifications()
+{
+    if (m_visibilityHooked)
+        return;
+    m_visibilityHooked = true;
+    if (QWindow *w = windowHandle())
+        w->installEventFilter(this);
+#ifdef Q_OS_WIN
+    // munkamenet-zárolás és kijelző-állapot: a Windows csak feliratkozás után küldi
+    const HWND hwnd = reinterpret_cast<HWND>(winId());
+    WTSRegisterSessionNotification(hwnd, NOTIFY_FOR_THIS_SESSION);
+    m_powerNotify = RegisterPowerSettingNotification(hwnd, &kConsoleDisplayState, DEVICE_NOTIFY_WINDOW_HANDLE);
+#endif
+}
+
+void CameraWall::setHiddenReason(HiddenReason r, bool on)
+{
+    const int prev = m_hiddenReasons;
+    m_hiddenReasons = on ? (prev | r) : (prev & ~r);
+    if (m_hiddenReasons == prev)
+        return;
+    qDebug() << "[CameraWall] hidden reasons" << Qt::hex << prev << "->" << m_hiddenReasons;
+
+    if (!prev)
+    {
+        if (m_hiddenStopDecodeMs >= 0)
+            hiddenStopTimer.start(m_hiddenStopDecodeMs);
+    }
+    else if (!m_hiddenReasons)
+    {
+        // gyors folytatás: SkipConvert-ből a következő frame már kirajzolódik
+        hiddenStopTimer.stop();
+        m_hiddenDecodeStopped = false;
+    }
+    applySuspendPolicy();
+}
+
+void CameraWall::resizeEvent(QResizeEvent *e)
+{
+    QMainWindow::resizeEvent(e);
+    scheduleProfileReevaluation(); // más csempe-méret → más profil lehet az ideális
+    applyFpsToTiles();             // és más FPS-plafon
+}
+
 void CameraWall::applyGridStretch()
 {
-    for (int r = 0; r < 9; ++r)
+    for (int r = 0; r < kMaxGridDim; ++r)
         grid->setRowStretch(r, 0);
-    for (int c = 0; c < 9; ++c)
+    for (int c = 0; c < kMaxGridDim; ++c)
         grid->setColumnStretch(c, 0);
     for (int r = 0; r < gridRows; ++r)
         grid->setRowStretch(r, 1);
@@ -273,19 +528,48 @@ void CameraWall::applyGridStretch()
         grid->setColumnStretch(c, 1);
 }
 
-void CameraWall::setGridN(int rc)
+void CameraWall::setGrid(int cols, int rows)
 {
-    // rc = C*10 + R  (C = columns, R = rows), pl. 32 -> 3 oszlop × 2 sor
-    int cols = rc / 10;
-    int rows = rc % 10;
-    if (rows <= 0 || cols <= 0 || rows > 9 || cols > 9)
+    if (rows <= 0 || cols <= 0 || rows > kMaxGridDim || cols > kMaxGridDim)
         return;
+    if (cols == gridCols && rows == gridRows)
+    {
+        updateGridChecks();
+        return;
+    }
 
+    // az első látható kamera maradjon a képen (az oldalszám a laponkénti darabszámmal változik)
+    const int firstCam = currentPage * perPage();
     gridCols = cols;
     gridRows = rows;
 
     saveViewToIni();
-    rebuildTiles();
+    showPage(firstCam / perPage()); // a kamerák nem változtak: a képen maradó streamek futnak tovább
+    applyFpsToTiles();              // kisebb cella → alacsonyabb FPS-plafon
+}
+
+void CameraWall::onCustomGrid()
+{
+    QDialog dlg(this);
+    dlg.setWindowTitle(Language::instance().t("dlg.customgrid", "Custom grid"));
+    auto *form = new QFormLayout(&dlg);
+    auto *spCols = new QSpinBox(&dlg);
+    auto *spRows = new QSpinBox(&dlg);
+    spCols->setRange(1, kMaxGridDim);
+    spRows->setRange(1, kMaxGridDim);
+    spCols->setValue(gridCols);
+    spRows->setValue(gridRows);
+    form->addRow(Language::instance().t("label.gridcols", "Columns:"), spCols);
+    form->addRow(Language::instance().t("label.gridrows", "Rows:"), spRows);
+    auto *btns = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dlg);
+    form->addRow(btns);
+    connect(btns, &QDialogButtonBox::accepted, &dlg, &QDialog::accept);
+    connect(btns, &QDialogButtonBox::rejected, &dlg, &QDialog::reject);
+
+    if (dlg.exec() == QDialog::Accepted)
+        setGrid(spCols->value(), spRows->value());
+    else
+        updateGridChecks(); // az „Egyéni…” pipa ne maradjon rajta
 }
 
 void CameraWall::onAdd()
@@ -312,9 +596,38 @@ void CameraWall::onEditSelected()
     EditCameraDialog dlg(&cur, this);
     if (dlg.exec() == QDialog::Accepted)
     {
-        cams[selectedIndex] = dlg.cameraResult();
+        Camera edited = dlg.cameraResult();
+        const bool sameStream = sameStreamSource(cur, edited);
+        if (sameStream && edited.mode == Camera::ONVIF)
+        {
+            // a feloldott URI továbbra is érvényes
+            edited.rtspUriCached = cur.rtspUriCached;
+            edited.rtspUriCachedHigh = cur.rtspUriCachedHigh;
+            edited.autoUriCache = cur.autoUriCache;
+            if (edited.onvifMediaXAddr.isEmpty())
+                edited.onvifMediaXAddr = cur.onvifMediaXAddr;
+        }
+        cams[selectedIndex] = edited;
         saveCamerasToIni();
-        rebuildTiles();
+
+        // más lejátszó háttér / FFmpeg-opciók: a feloldott címek maradnak, de a csempék újranyitnak
+        const bool samePlayer = cur.backend == edited.backend && cur.avOptions == edited.avOptions;
+        if (!sameStream || !samePlayer)
+        {
+            rebuildTiles();
+            return;
+        }
+
+        // csak név / képarány / FPS változott: élőben alkalmazzuk, újrakapcsolódás nélkül
+        for (auto it = tileIndexMap.cbegin(); it != tileIndexMap.cend(); ++it)
+        {
+            if (it.value() != selectedIndex)
+                continue;
+            it.key()->setName(edited.name);
+            it.key()->setAspectMode(edited.aspectMode);
+            it.key()->setMaxFps(effectiveFpsFor(selectedIndex, it.key() == focusTile));
+            it.key()->setSubStreamAvailable(hasProfileChoice(edited));
+        }
     }
 }
 
@@ -387,7 +700,43 @@ void CameraWall::toggleFpsLimit()
     m_limitFps15 = !m_limitFps15;
     actFps->setChecked(m_limitFps15);
     saveViewToIni();
-    rebuildTiles();
+    applyFpsToTiles(); // nem kell újrakapcsolódni, a szabályzó élőben vált
+}
+
+double CameraWall::effectiveFpsFor(int camIdx, bool focus) const
+{
+    double fps = m_limitFps15 ? 15.0 : 0.0;
+    if (camIdx >= 0 && camIdx < cams.size() && cams[camIdx].maxFps > 0)
+        fps = cams[camIdx].maxFps;
+    if (focus)
+        return fps;
+
+    // sok kis csempénél a részletek úgysem látszanak: a cella méretével arányos plafon
+    const double cap = fpsCapForTilePx(expectedTilePx(false));
+    if (cap > 0.0 && (fps <= 0.0 || cap < fps))
+        fps = cap;
+    return fps;
+}
+
+double CameraWall::fpsCapForTilePx(const QSize &px)
+{
+    const int w = px.width();
+    if (w <= 0)
+        return 0.0;
+    if (w < 240)
+        return 5.0;
+    if (w < 400)
+        return 10.0;
+    if (w < 640)
+        return 15.0;
+    return 0.0; // nagy csempe: nincs méret szerinti korlát
+}
+
+void CameraWall::applyFpsToTiles()
+{
+    for (auto it = tileIndexMap.cbegin(); it != tileIndexMap.cend(); ++it)
+        if (it.key())
+            it.key()->setMaxFps(effectiveFpsFor(it.value(), it.key() == focusTile));
 }
 
 void CameraWall::toggleAutoRotate()
@@ -395,10 +744,7 @@ void CameraWall::toggleAutoRotate()
     m_autoRotate = !m_autoRotate;
     actAutoRotate->setChecked(m_autoRotate);
     saveViewToIni();
-    if (m_autoRotate)
-        rotateTimer.start();
-    else
-        rotateTimer.stop();
+    showPage(currentPage); // forgatás és előre kapcsolás időzítőinek újraindítása
 }
 
 void CameraWall::toggleKeepAlive()
@@ -406,6 +752,8 @@ void CameraWall::toggleKeepAlive()
     m_keepBackgroundStreams = !m_keepBackgroundStreams;
     actKeepAlive->setChecked(m_keepBackgroundStreams);
     saveViewToIni();
+    enforceStreamBudget();
+    applySuspendPolicy();
 }
 
 void CameraWall::onTileFullscreenRequested()
@@ -430,11 +778,26 @@ void CameraWall::nextPage()
 {
     if (!m_autoRotate)
         return;
-    const int pages = qMax(1, (cams.size() + perPage() - 1) / perPage());
+    if (focusTile)
+        return; // fókusz nézetben nem lapozunk a háttérben
+    if (m_hiddenReasons)
+        return; // senki nem látja: a folytatáskor az aktuális oldal azonnal kész
+    const int pages = pageCount();
     if (pages <= 1)
         return;
-    currentPage = (currentPage + 1) % pages;
-    rebuildTiles();
+    const int next = (currentPage + 1) % pages;
+
+    // a beérkező oldal streamjei jó esetben már futnak (preconnect); csak akkor váltunk,
+    // ha mindegyiknek van képe – legkésőbb a határidő lejártakor
+    preconnectPage(next);
+    if (pageReady(next))
+    {
+        showPage(next);
+        return;
+    }
+    m_pendingPage = next;
+    flipDeadline.start();
+    qDebug() << "[nextPage] waiting for first frames of page" << next;
 }
 
 void CameraWall::reloadAll()
@@ -445,51 +808,346 @@ void CameraWall::reloadAll()
     rebuildTiles();
 }
 
-QUrl CameraWall::playbackUrlFor(int camIdx, bool /*high*/, QString *errOut)
+QUrl CameraWall::playbackUrlFor(int camIdx, bool high, QString *errOut)
 {
     if (camIdx < 0 || camIdx >= cams.size())
         return QUrl();
     const Camera &c = cams[camIdx];
 
+    // automatikus profil: a várható csempe-méret alapján (a tényleges méretre később igazítunk)
+    if (c.mode == Camera::ONVIF && c.onvifAutoProfile && !c.onvifProfiles.isEmpty())
+        return autoPlaybackUrlFor(camIdx, expectedTilePx(high), errOut);
+
+    // fő stream csak akkor, ha a kamerához külön meg van adva
+    high = high && hasHighStream(c);
+
     if (c.mode == Camera::RTSP)
-        return c.rtspManual;
+        return high ? c.rtspManualHigh : c.rtspManual;
 
-    // ONVIF – csak a cache-t használjuk, ha nincs, kliensből kérd le (nálad meglévő OnvifClient-tel)
-    QString uri = c.rtspUriCached;
+    // ONVIF – csak a cache-t használjuk; ha nincs, a háttérben lekérjük, és a csempe utána indul
+    const QString token = high ? c.onvifHighToken : c.onvifChosenToken;
+    const QString uri = high ? c.rtspUriCachedHigh : c.rtspUriCached;
     if (uri.isEmpty())
     {
-        OnvifClient cli;
-        QString err;
-        QUrl media = c.onvifMediaXAddr;
-        if (media.isEmpty())
+        if (token.isEmpty())
         {
-            QUrl med;
-            if (!cli.getCapabilities(c.onvifDeviceXAddr, c.onvifUser, c.onvifPass, med, &err))
+            if (errOut)
+                *errOut = Language::instance().t("msg.missingonvif", "Missing ONVIF profile token");
+            return QUrl();
+        }
+        requestOnvifUri(camIdx, token, high ? HighUri : GridUri);
+        if (errOut)
+            *errOut = Language::instance().t("msg.resolvingonvif", "Resolving ONVIF stream address…");
+        return QUrl();
+    }
+    QUrl u = QUrl::fromEncoded(uri.toUtf8());
+    u = Util::withCredentials(u, c.onvifUser, c.onvifPass);
+    return u;
+}
+
+void CameraWall::requestOnvifUri(int camIdx, const QString &token, UriSlot slot, bool refreshMedia)
+{
+    const Camera &c = cams[camIdx];
+    const QUrl device = c.onvifDeviceXAddr;
+    const QString key = QString("%1|%2|%3").arg(device.toString(), token).arg(int(slot));
+    if (token.isEmpty() || m_uriResolving.contains(key))
+        return; // ugyanerre már fut kérés (pl. két csempe ugyanazzal a kamerával)
+    m_uriResolving.insert(key);
+
+    const QString user = c.onvifUser;
+    const QString pass = c.onvifPass;
+    auto fetchUri = [this, key, device, user, pass, token, slot](const QUrl &media)
+    {
+        OnvifClient::instance().getStreamUri(media, user, pass, token, this,
+                                             [this, key, device, token, slot, media](bool ok, const QString &uri, const QString &err)
+                                             { onOnvifUriResolved(key, device, media, token, slot, ok ? uri : QString(), err); });
+    };
+
+    // a media címet csak akkor kérjük újra, ha nincs, vagy gyanús (ismétlődő RTSP hibák)
+    if (!refreshMedia && !c.onvifMediaXAddr.isEmpty())
+    {
+        fetchUri(c.onvifMediaXAddr);
+        return;
+    }
+    OnvifClient::instance().getCapabilities(device, user, pass, this,
+                                            [this, key, device, token, slot, fetchUri](bool ok, const QUrl &media, const QString &err)
+                                            {
+        if (!ok)
+        {
+            onOnvifUriResolved(key, device, QUrl(), token, slot, QString(), err);
+            return;
+        }
+        fetchUri(media); });
+}
+
+void CameraWall::onOnvifUriResolved(const QString &key, const QUrl &device, const QUrl &media, const QString &token,
+                                    UriSlot slot, const QString &uri, const QString &err)
+{
+    m_uriResolving.remove(key);
+    qDebug() << "[onOnvifUriResolved]" << device.host() << token << (uri.isEmpty() ? err : QString("ok"));
+
+    // a kameralista közben változhatott: eszköz + token alapján keresünk (több bejegyzés is lehet)
+    for (int i = 0; i < cams.size(); ++i)
+    {
+        Camera &c = cams[i];
+        if (c.mode != Camera::ONVIF || c.onvifDeviceXAddr != device)
+            continue;
+        if (uri.isEmpty())
+        {
+            if (VideoTile *t = tilePool.value(i); t && t->url().isEmpty())
+                t->setToolTip(err); // csak ha nincs mit játszania; a régi cím marad
+            continue;
+        }
+
+        bool used = false;
+        bool changed = false;
+        bool persistent = false; // az ini-ben tárolt mező változott (nem csak a memóriabeli auto-cache)
+        auto store = [&](QString &field)
+        {
+            used = true;
+            persistent = persistent || field != uri;
+            changed = changed || field != uri;
+            field = uri;
+        };
+        switch (slot)
+        {
+        case GridUri:
+            if (c.onvifChosenToken == token)
+                store(c.rtspUriCached);
+            break;
+        case HighUri:
+            if (c.onvifHighToken == token)
+                store(c.rtspUriCachedHigh);
+            break;
+        case AutoUri:
+            if (c.onvifAutoProfile)
             {
-                if (errOut)
-                    *errOut = err;
-                return QUrl();
+                used = true;
+                changed = c.autoUriCache.value(token) != uri;
+                c.autoUriCache.insert(token, uri); // csak memóriában
             }
-            media = med;
+            break;
         }
-        if (c.onvifChosenToken.isEmpty())
+        if (!used)
+            continue;
+        if (!media.isEmpty() && media != c.onvifMediaXAddr)
         {
-            if (errOut)
-                *errOut = Language::instance().t("msg.missingonvif", "Missing ONVIF profile token");
-            return QUrl();
+            c.onvifMediaXAddr = media; // pl. DHCP-váltás után más a media szolgáltatás címe
+            changed = true;
+            persistent = true;
         }
-        if (!cli.getStreamUri(media, c.onvifUser, c.onvifPass, c.onvifChosenToken, uri, &err))
+        c.uriValidatedAt = QDateTime::currentDateTimeUtc();
+
+        if (changed)
         {
-            if (errOut)
-                *errOut = err;
-            return QUrl();
+            qDebug() << "[onOnvifUriResolved] stream address changed:" << c.name << token;
+            refreshTileUrl(i);
         }
-        cams[camIdx].rtspUriCached = uri;
-        saveCamerasToIni();
+        // csak a ténylegesen változott kamera kerül az ini-be, nem a teljes lista; megerősített
+        // (változatlan) címnél csak az időbélyeg, különben újraindítás után a TTL lejártnak látszana
+        if (persistent)
+            saveCameraToIni(i);
+        else
+            saveCameraValidatedAt(i);
+    }
+}
+
+void CameraWall::refreshTileUrl(int camIdx)
+{
+    VideoTile *tile = tilePool.value(camIdx);
+    if (!tile)
+        return;
+    const Camera &c = cams[camIdx];
+    QString err;
+    QUrl url;
+    if (c.mode == Camera::ONVIF && c.onvifAutoProfile && !c.onvifProfiles.isEmpty())
+    {
+        const QSize px = autoProfilePx(tile);
+        QString token;
+        url = autoPlaybackUrlFor(camIdx, px, &err, &token);
+        if (!url.isEmpty())
+            autoTokenOfTile[tile] = token;
+    }
+    else
+    {
+        url = playbackUrlFor(camIdx, tile == focusTile, &err);
+    }
+    if (url.isEmpty())
+        return; // még egy másik feloldásra vár
+    tile->setToolTip(QString());
+    if (url != tile->url())
+        tile->playUrl(url);
+}
+
+void CameraWall::revalidateCameraUris(int camIdx, bool refreshMedia)
+{
+    const Camera &c = cams[camIdx];
+    if (c.mode != Camera::ONVIF)
+        return;
+    qDebug() << "[revalidateCameraUris]" << c.name << "refreshMedia=" << refreshMedia;
+    if (!c.rtspUriCached.isEmpty())
+        requestOnvifUri(camIdx, c.onvifChosenToken, GridUri, refreshMedia);
+    if (!c.rtspUriCachedHigh.isEmpty())
+        requestOnvifUri(camIdx, c.onvifHighToken, HighUri, refreshMedia);
+    const QStringList autoTokens = c.autoUriCache.keys();
+    for (const QString &token : autoTokens)
+        requestOnvifUri(camIdx, token, AutoUri, refreshMedia);
+}
+
+void CameraWall::revalidateStaleUris()
+{
+    // lejárt TTL: háttérben újrakérjük; ha nem változott, nincs újrakapcsolódás
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    for (int i = 0; i < cams.size(); ++i)
+    {
+        const Camera &c = cams[i];
+        if (c.mode != Camera::ONVIF)
+            continue;
+        if (c.uriValidatedAt.isValid() && c.uriValidatedAt.secsTo(now) < m_uriTtlSec)
+            continue;
+        revalidateCameraUris(i, false);
+    }
+}
+
+void CameraWall::onTileConnectFailing(int consecutiveFailures)
+{
+    auto *tile = qobject_cast<VideoTile *>(sender());
+    const int camIdx = tileIndexMap.value(tile, -1);
+    if (camIdx < 0 || camIdx >= cams.size() || cams[camIdx].mode != Camera::ONVIF)
+        return;
+    if (m_reresolveAfterFailures <= 0 || consecutiveFailures % m_reresolveAfterFailures != 0)
+        return;
+    // N egymás utáni RTSP hiba: lehet, hogy a cím változott (firmware, DHCP) – teljes újrafeloldás
+    revalidateCameraUris(camIdx, true);
+}
+
+void CameraWall::onTileQualityTierChanged(int tier)
+{
+    auto *tile = qobject_cast<VideoTile *>(sender());
+    const int camIdx = tileIndexMap.value(tile, -1);
+    if (camIdx < 0 || camIdx >= cams.size() || tilePool.value(camIdx) != tile)
+        return;
+    // az FPS-plafont a csempe maga alkalmazza; profilt csak automatikus profilnál választunk
+    const Camera &c = cams[camIdx];
+    if (!hasProfileChoice(c))
+        return;
+    qDebug() << "[onTileQualityTierChanged]" << c.name << "tier" << tier;
+    refreshTileUrl(camIdx);
+}
+
+bool CameraWall::hasProfileChoice(const Camera &c)
+{
+    // a SubStream szint csak automatikus profilválasztásnál vált kisebb profilra
+    return c.mode == Camera::ONVIF && c.onvifAutoProfile && c.onvifProfiles.size() > 1;
+}
+
+QSize CameraWall::autoProfilePx(VideoTile *tile) const
+{
+    // SubStream szinttől a legkisebb profil (1×1-et bármelyik lefedi)
+    if (tile->qualityTier() >= VideoTile::SubStream)
+        return QSize(1, 1);
+    // a tényleges csempe-méretből választ (rejtett csempénél a várhatóból)
+    return tile->isVisible() ? (QSizeF(tile->size()) * tile->devicePixelRatioF()).toSize()
+                             : expectedTilePx(tile == focusTile);
+}
+
+QUrl CameraWall::autoPlaybackUrlFor(int camIdx, const QSize &tilePx, QString *errOut, QString *tokenOut)
+{
+    Camera &c = cams[camIdx];
+    const QString token = autoProfileToken(c, tilePx);
+    if (tokenOut)
+        *tokenOut = token;
+
+    const QString uri = c.autoUriCache.value(token);
+    if (uri.isEmpty())
+    {
+        requestOnvifUri(camIdx, token, AutoUri);
+        if (errOut)
+            *errOut = Language::instance().t("msg.resolvingonvif", "Resolving ONVIF stream address…");
+        return QUrl();
     }
     QUrl u = QUrl::fromEncoded(uri.toUtf8());
-    u = Util::withCredentials(u, c.onvifUser, c.onvifPass);
-    return u;
+    return Util::withCredentials(u, c.onvifUser, c.onvifPass);
+}
+
+QSize CameraWall::expectedTilePx(bool focus) const
+{
+    // a csempék még nincsenek elrendezve: a rács-cella / fókusz oldal méretéből becsülünk
+    const qreal dpr = devicePixelRatioF();
+    const QSize area = central ? central->size() : size();
+    if (focus)
+        return (QSizeF(area) * dpr).toSize();
+    const int sp = grid ? grid->spacing() : 0;
+    const QSizeF cell((area.width() - sp * (gridCols - 1)) / qreal(qMax(1, gridCols)),
+                      (area.height() - sp * (gridRows - 1)) / qreal(qMax(1, gridRows)));
+    return (cell * dpr).toSize();
+}
+
+void CameraWall::scheduleProfileReevaluation()
+{
+    // átméretezés közben ne kapcsolgassunk: a méret beállta után egyszer döntünk
+    profileTimer.start();
+}
+
+void CameraWall::reevaluateAutoProfiles()
+{
+    for (auto it = tileIndexMap.cbegin(); it != tileIndexMap.cend(); ++it)
+    {
+        VideoTile *tile = it.key();
+        const int camIdx = it.value();
+        if (!tile || camIdx < 0 || camIdx >= cams.size() || !tile->isVisible())
+            continue; // rejtett (előre kapcsolt / háttér) csempének nincs valós mérete
+        const Camera &c = cams[camIdx];
+        if (c.mode != Camera::ONVIF || !c.onvifAutoProfile || c.onvifProfiles.isEmpty())
+            continue;
+
+        const QSize px = autoProfilePx(tile);
+        const QString token = autoProfileToken(c, px);
+        if (autoTokenOfTile.value(tile) == token)
+            continue;
+
+        QString err;
+        const QUrl url = autoPlaybackUrlFor(camIdx, px, &err);
+        if (url.isEmpty())
+        {
+            qDebug() << "[reevaluateAutoProfiles] resolve failed" << c.name << token << err;
+            continue;
+        }
+        autoTokenOfTile[tile] = token;
+        if (url == tile->url())
+            continue;
+        qDebug() << "[reevaluateAutoProfiles]" << c.name << "tile" << px << "-> profile" << token;
+        tile->playUrl(url);
+    }
+}
+
+void CameraWall::switchTileStream(VideoTile *tile, bool high)
+{
+    if (!tile)
+        return;
+    const int camIdx = tileIndexMap.value(tile, -1);
+    if (camIdx < 0 || camIdx >= cams.size())
+        return;
+    if (cams[camIdx].mode == Camera::ONVIF && cams[camIdx].onvifAutoProfile)
+    {
+        scheduleProfileReevaluation(); // a profil a csempe új méretéből adódik
+        return;
+    }
+    if (!hasHighStream(cams[camIdx]))
+        return; // nincs külön fő stream: marad, ami megy
+
+    QString err;
+    const QUrl url = playbackUrlFor(camIdx, high, &err);
+    if (url.isEmpty())
+    {
+        qDebug() << "[switchTileStream] no url for" << camIdx << "high=" << high << err;
+        return; // inkább a másik stream fusson, mint semmi
+    }
+    if (url == tile->url())
+        return;
+
+    qDebug() << "[switchTileStream]" << cams[camIdx].name << (high ? "-> main stream" : "-> sub stream");
+    tile->playUrl(url);
 }
 
 void CameraWall::enterFocus(int camIdx)
@@ -537,6 +1195,8 @@ void CameraWall::enterFocus(int camIdx)
     focusCol = cFound;
 
     stack->setCurrentWidget(pageFocus);
+    switchTileStream(tile, true); // fókuszban a fő (nagy felbontású) stream
+    applySuspendPolicy();         // a háttérben maradt csempék ne dekódoljanak/konvertáljanak
 
     // Súgó a fókusz nézethez
     showDefaultStatusHint();
@@ -568,9 +1228,11 @@ void CameraWall::exitFocus()
         focusPlaceholder = nullptr;
     }
 
+    switchTileStream(focusTile, false); // vissza az olcsó al-streamre
     focusTile = nullptr;
     m_focusCamIdx = -1;
     focusRow = focusCol = -1;
+    applySuspendPolicy(); // rács tovább: a felfüggesztett csempék folytatják
 
     // csak a stack oldalt kapcsoljuk – a főablak geometriáját NEM bántjuk
     stack->setCurrentWidget(pageGrid);
@@ -580,18 +1242,91 @@ void CameraWall::exitFocus()
 }
 
 void CameraWall::rebuildTiles()
+{
+    // teljes újraépítés (kamera-lista változott): a készlet kamera-indexei érvénytelenek
+    clearTilePool();
+    showPage(currentPage);
+}
+
+void CameraWall::clearTilePool()
+{
+    if (focusTile)
+        exitFocus();
+    for (VideoTile *t : std::as_const(tilePool))
+    {
+        if (!t)
+            continue;
+        grid->removeWidget(t);
+        t->stop();
+        t->deleteLater();
+    }
+    tilePool.clear();
+    tileLastShown.clear();
+    tileIndexMap.clear();
+    autoTokenOfTile.clear();
+    tiles.clear();
+    m_pendingPage = -1;
+    flipDeadline.stop();
+}
+
+VideoTile *CameraWall::acquireTile(int camIdx)
+{
+    if (VideoTile *t = tilePool.value(camIdx))
+        return t;
+
+    auto *tile = new VideoTile(effectiveFpsFor(camIdx), pageGrid);
+    tile->setCompositor(compositor);
+    tile->setMakeBeforeBreak(m_makeBeforeBreak);
+    tile->setStreamBackend(cams[camIdx].backend, cams[camIdx].avOptions);
+    tile->setSubStreamAvailable(hasProfileChoice(cams[camIdx]));
+    tile->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    tile->hide(); // a showPage teszi ki; előre kapcsolt oldalnál rejtve vár
+    // a várható cella-méret: az első frame-ek már jó méretben készülnek
+    tile->resize((QSizeF(expectedTilePx(false)) / devicePixelRatioF()).toSize());
+
+    tile->setName(cams[camIdx].name);
+    tile->setAspectMode(cams[camIdx].aspectMode);
+    tile->setAdmissionPriority(camIdx / perPage() == currentPage ? 1 : 0); // előre kapcsolt oldal hátrébb
+    connect(tile, &VideoTile::fullscreenRequested, this, &CameraWall::onTileFullscreenRequested);
+    connect(tile, &VideoTile::firstFrameReady, this, &CameraWall::onTileFirstFrame);
+    connect(tile, &VideoTile::connectFailing, this, &CameraWall::onTileConnectFailing);
+    connect(tile, &VideoTile::qualityTierChanged, this, &CameraWall::onTileQualityTierChanged);
+    tileIndexMap[tile] = camIdx;
+    tilePool[camIdx] = tile;
+
+    QString err;
+    QUrl play = playbackUrlFor(camIdx, false, &err);
+    if (play.isEmpty())
+        tile->setToolTip(err);
+    else
+        tile->playUrl(play);
+    return tile;
+}
+
+void CameraWall::showPage(int page)
 {
     applyGridStretch();
+    if (focusTile)
+        exitFocus();
 
-    // rács törlése (csak a rács oldalon)
+    // rács ürítése: a csempék a készletben maradnak (stream fut tovább), csak kikerülnek a rácsból
     while (QLayoutItem *child = grid->takeAt(0))
     {
         if (auto *w = child->widget())
-            w->deleteLater();
+        {
+            auto *vt = qobject_cast<VideoTile *>(w);
+            if (vt && tileIndexMap.contains(vt))
+                vt->hide();
+            else
+                w->deleteLater();
+        }
         delete child;
     }
     tiles.clear();
-    tileIndexMap.clear();
+    m_pendingPage = -1;
+    m_preconnectedPage = -1;
+    flipDeadline.stop();
+    preconnectTimer.stop();
 
     if (cams.isEmpty())
     {
@@ -605,9 +1340,8 @@ void CameraWall::rebuildTiles()
         return;
     }
 
-    const int pages = qMax(1, (cams.size() + perPage() - 1) / perPage());
-    if (currentPage >= pages)
-        currentPage = 0;
+    const int pages = pageCount();
+    currentPage = (page >= 0 && page < pages) ? page : 0;
     if (m_autoRotate && cams.size() > perPage())
         rotateTimer.start();
     else
@@ -615,62 +1349,191 @@ void CameraWall::rebuildTiles()
 
     const int start = currentPage * perPage();
     const int end = qMin(start + perPage(), cams.size());
+    ++m_pageSerial;
 
     int shown = 0;
     for (int i = start; i < end; ++i)
     {
-        auto *tile = new VideoTile(m_limitFps15, pageGrid);
-        tile->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+        VideoTile *tile = acquireTile(i);
         tiles << tile;
+        tileLastShown[i] = m_pageSerial;
 
         // rácspozíció: sor = shown / gridCols, oszlop = shown % gridCols
         const int r = shown / gridCols;
         const int c = shown % gridCols;
         grid->addWidget(tile, r, c);
-
-        // név + URL
-        tile->setName(cams[i].name);
-        QString err;
-        QUrl play = playbackUrlFor(i, false, &err);
-        if (play.isEmpty())
-            tile->setToolTip(err);
-        else
-            tile->playUrl(play);
-
-        // --- Aspect mód alkalmazása a csempére ---
-        tile->setAspectMode(cams[i].aspectMode);
-
-        connect(tile, &VideoTile::fullscreenRequested, this, &CameraWall::onTileFullscreenRequested);
-        tileIndexMap[tile] = i;
+        tile->show();
         shown++;
     }
 
     grid->invalidate();
     stack->setCurrentWidget(pageGrid);
+    scheduleProfileReevaluation(); // a becsült méret helyett a ténylegesre igazítunk
+    enforceStreamBudget();
+    applySuspendPolicy();
+
+    // a következő oldal streamjei a forgatás előtt „lead” idővel elindulnak (rejtve)
+    if (rotateTimer.isActive())
+    {
+        preconnectTimer.setInterval(qMax(0, rotateTimer.interval() - m_preconnectLeadMs));
+        preconnectTimer.start();
+    }
 
-    const int pagesCount = qMax(1, (cams.size() + perPage() - 1) / perPage());
     statusBar()->showMessage(
-        QString("%1: %2 • %3/%4 • %5 • %6 %7×%8 • FPS: %9")
+        QString("%1: %2 • %3/%4 • %5 • %6 %7×%8 • %9 %10")
             .arg(Language::instance().t("status.cams", "Cameras"))
             .arg(cams.size())
             .arg(currentPage + 1)
-            .arg(pagesCount)
+            .arg(pages)
             .arg(cams.size() > perPage() ? Language::instance().t("status.rotate", "10s rotate")
                                          : Language::instance().t("status.allvisible", "all visible"))
             .arg(Language::instance().t("status.grid", "Grid:"))
             .arg(gridCols)
             .arg(gridRows)
-            .arg(m_limitFps15 ? "15" : "max"));
+            .arg(Language::instance().t("status.defaultfps", "Default FPS:")) // kameránként felülírható
+            .arg(m_limitFps15 ? QStringLiteral("15") : Language::instance().t("status.fpsmax", "max")));
     updateGridChecks();
 }
 
-void CameraWall::loadFromIni()
+void CameraWall::preconnectPage(int page)
 {
-    QSettings s(Util::iniPath(), QSettings::IniFormat);
+    if (page < 0 || page >= pageCount() || page == currentPage)
+        return;
+    const int start = page * perPage();
+    const int end = qMin(start + perPage(), cams.size());
+    for (int i = start; i < end; ++i)
+        acquireTile(i);
+    m_preconnectedPage = page;
+    applySuspendPolicy(); // a beérkező oldalnak első frame-ek kellenek
+    qDebug() << "[preconnectPage]" << page << "cams" << start << ".." << end - 1;
+}
+
+void CameraWall::applySuspendPolicy()
+{
+    // háttér: kapcsolat tartása konverzió nélkül (keep-alive), vagy teljes leállítás
+    const VideoTile::SuspendLevel background =
+        m_keepBackgroundStreams ? VideoTile::SkipConvert : VideoTile::Stopped;
+    // a fal egésze láthatatlan (kis méret, takarás, kijelző ki, zárolás): minden csempe legalább ennyire áll.
+    // hiddenStopDecodeSec = -1 (alap): csak SkipConvert, a kapcsolatok élnek; a rejtve újrakapcsolódó
+    // csempe kézfogása a forrás első frame-jén zárul (VideoTile::onSourceFrame), konverzió nélkül is
+    const VideoTile::SuspendLevel hidden = !m_hiddenReasons ? VideoTile::Active
+                                           : m_hiddenDecodeStopped ? VideoTile::Stopped
+                                                                   : VideoTile::SkipConvert;
+    const int per = perPage();
+    auto onPage = [per](int camIdx, int page)
+    { return page >= 0 && camIdx / per == page; };
+
+    for (auto it = tilePool.cbegin(); it != tilePool.cend(); ++it)
+    {
+        VideoTile *t = it.value();
+        if (!t)
+            continue;
+        const int camIdx = it.key();
+        VideoTile::SuspendLevel level = VideoTile::Active;
+        if (focusTile)
+            level = (t == focusTile) ? VideoTile::Active : background; // fókusz alatt a rács rejtve
+        else if (!onPage(camIdx, currentPage) && !onPage(camIdx, m_preconnectedPage) &&
+                 !onPage(camIdx, m_pendingPage))
+            level = VideoTile::SkipConvert; // korábban látott oldal: csak a keret miatt él még
+
+        // kapcsolódási sor: a fókuszált, majd a látható oldal nyit előbb
+        level = VideoTile::SuspendLevel(qMax(int(level), int(hidden)));
+        const bool visible = focusTile ? (t == focusTile) : onPage(camIdx, currentPage);
+        t->setAdmissionPriority(t == focusTile ? 2 : (visible ? 1 : 0));
+        t->setSuspendLevel(level);
+        if (t == focusTile)
+            t->setQualityTier(VideoTile::FullQuality, 0.0); // a fókusz nem várja meg a következő mintavételt
+    }
+    applyFpsToTiles(); // a fókuszba került csempére nem vonatkozik a cella-méret szerinti plafon
+}
+
+bool CameraWall::pageReady(int page) const
+{
+    const int start = page * perPage();
+    const int end = qMin(start + perPage(), cams.size());
+    for (int i = start; i < end; ++i)
+    {
+        const VideoTile *t = tilePool.value(i);
+        if (!t)
+            return false;
+        // URL nélküli (hibás) kamera nem tarthatja vissza a lapozást
+        if (!t->hasFrame() && t->url().isValid())
+            return false;
+    }
+    return true;
+}
+
+void CameraWall::onTileFirstFrame()
+{
+    if (m_pendingPage >= 0 && pageReady(m_pendingPage))
+    {
+        qDebug() << "[onTileFirstFrame] incoming page ready -> flip" << m_pendingPage;
+        showPage(m_pendingPage);
+    }
+}
+
+void CameraWall::enforceStreamBudget()
+{
+    // védett: az aktuális oldal és (ha már előre kapcsoltuk) a következő
+    QSet<int> keep;
+    auto protectPage = [&](int page)
+    {
+        if (page < 0)
+            return;
+        const int start = page * perPage();
+        for (int i = start; i < qMin(start + perPage(), cams.size()); ++i)
+            keep.insert(i);
+    };
+    protectPage(currentPage);
+    protectPage(m_pendingPage);
+    protectPage(m_preconnectedPage); // a lead-időben előre kapcsolt oldal se induljon hidegen
+    if (focusTile)
+        keep.insert(tileIndexMap.value(focusTile, -1));
+
+    // háttér-streamek nélkül csak a védettek maradnak; egyébként a keret erejéig a legutóbb látottak
+    const int budget = m_keepBackgroundStreams ? qMax(streamBudget(), keep.size()) : keep.size();
+
+    QList<int> candidates;
+    for (auto it = tilePool.cbegin(); it != tilePool.cend(); ++it)
+        if (!keep.contains(it.key()))
+            candidates << it.key();
+    std::sort(candidates.begin(), candidates.end(), [this](int a, int b)
+              { return tileLastShown.value(a) < tileLastShown.value(b); }); // legrégebben látott elöl
+
+    for (int camIdx : std::as_const(candidates))
+    {
+        if (tilePool.size() <= budget)
+            break;
+        VideoTile *t = tilePool.take(camIdx);
+        tileLastShown.remove(camIdx);
+        if (!t)
+            continue;
+        qDebug() << "[enforceStreamBudget] release" << cams.value(camIdx).name;
+        tileIndexMap.remove(t);
+        autoTokenOfTile.remove(t);
+        t->stop();
+        t->deleteLater();
+    }
+}
+
+int CameraWall::streamBudget() const
+{
+    // 0 = automatikus: két oldalnyi stream; nagy rácsnál a tartalék legfeljebb 16 (64 csempe mellé ne 64 háttér-stream)
+    return m_streamBudget > 0 ? m_streamBudget : perPage() + qMin(perPage(), 16);
+}
 
-    // Cameras
+QString CameraWall::wallGroup(const QString &group) const
+{
+    // az első fal a régi (előtag nélküli) csoportokat használja
+    return m_wallIndex == 0 ? group : QString("Wall%1/%2").arg(m_wallIndex).arg(group);
+}
+
+void CameraWall::loadCamerasFromIni(QSettings &s)
+{
+    // Cameras – további falaknál saját lista, ha van; különben az első fal listája (közösen, csak olvasva)
     cams.clear();
-    s.beginGroup("Cameras");
+    m_camsGroup = s.contains(wallGroup("Cameras") + "/count") ? wallGroup("Cameras") : QString("Cameras");
+    s.beginGroup(m_camsGroup);
     int count = s.value("count", 0).toInt();
     for (int i = 0; i < count; ++i)
     {
@@ -681,6 +1544,7 @@ void CameraWall::loadFromIni()
         if (c.mode == Camera::RTSP)
         {
             c.rtspManual = Util::urlFromEncoded(s.value("rtsp").toString());
+            c.rtspManualHigh = Util::urlFromEncoded(s.value("rtsp_high").toString());
         }
         else
         {
@@ -689,7 +1553,23 @@ void CameraWall::loadFromIni()
             c.onvifUser = s.value("onvif_user").toString();
             c.onvifPass = s.value("onvif_pass").toString();
             c.onvifChosenToken = s.value("onvif_token").toString();
+            c.onvifHighToken = s.value("onvif_token_high").toString();
             c.rtspUriCached = s.value("rtsp_cached").toString();
+            c.rtspUriCachedHigh = s.value("rtsp_cached_high").toString();
+            c.uriValidatedAt = QDateTime::fromString(s.value("rtsp_cached_at").toString(), Qt::ISODate);
+            c.onvifAutoProfile = s.value("onvif_auto", false).toBool();
+            const int np = s.beginReadArray("profiles");
+            for (int k = 0; k < np; ++k)
+            {
+                s.setArrayIndex(k);
+                OnvifProfile p;
+                p.token = s.value("token").toString();
+                p.name = s.value("name").toString();
+                p.encoding = s.value("encoding").toString();
+                p.resolution = QSize(s.value("width", -1).toInt(), s.value("height", -1).toInt());
+                c.onvifProfiles << p;
+            }
+            s.endArray();
         }
 
         // --- Aspect mód betöltése (alap: Fit) ---
@@ -711,21 +1591,33 @@ void CameraWall::loadFromIni()
             c.aspectMode = strToAspect(s.value("aspect", "fit").toString());
         }
 
+        c.maxFps = qBound(0, s.value("maxFps", 0).toInt(), 60);
+        c.backend = (s.value("backend", "qt").toString() == "libav") ? StreamSource::LibAv : StreamSource::QtMultimedia;
+        c.avOptions = s.value("av_options").toString();
+
         if (c.name.isEmpty())
             c.name = (c.mode == Camera::RTSP ? c.rtspManual.host() : c.onvifDeviceXAddr.host());
         cams << c;
         s.endGroup();
     }
     s.endGroup();
+}
 
-    // View – grid, egyéb beállítások
-    s.beginGroup("View");
-    const int rc = s.value("gridN", 22).toInt(); // 22=2×2, 33=3×3, 32=3×2 (oszlop×sor)
-    int cols = rc / 10;
-    int rows = rc % 10;
-    if (cols <= 0)
+void CameraWall::loadFromIni()
+{
+    QSettings s(Util::iniPath(), QSettings::IniFormat);
+
+    loadCamerasFromIni(s);
+
+    // View – grid, egyéb beállítások (falanként; amíg nincs saját, az első falé az alap)
+    s.beginGroup(s.contains(wallGroup("View") + "/autoRotate") ? wallGroup("View") : QString("View"));
+    // rács: gridCols/gridRows; régebbi ini-ben kétjegyű gridN (22=2×2, 32=3×2, oszlop×sor)
+    const int rc = s.value("gridN", 22).toInt();
+    int cols = s.value("gridCols", rc / 10).toInt();
+    int rows = s.value("gridRows", rc % 10).toInt();
+    if (cols <= 0 || cols > kMaxGridDim)
         cols = 2;
-    if (rows <= 0)
+    if (rows <= 0 || rows > kMaxGridDim)
         rows = 2;
     gridCols = cols;
     gridRows = rows;
@@ -736,6 +1628,13 @@ void CameraWall::loadFromIni()
     backgroundFromIni = s.value("backgroundPath").toString();
     backgroundCleared = s.value("backgroundCleared", false).toBool();
     m_statusbarVisible = s.value("statusbarVisible", true).toBool();
+    m_repaintHz = qBound(0, s.value("repaintHz", 60).toInt(), 240);
+    m_preconnectLeadMs = qBound(0, s.value("preconnectLeadMs", 3000).toInt(), 9000);
+    m_streamBudget = qBound(0, s.value("streamBudget", 0).toInt(), 256);
+    m_makeBeforeBreak = s.value("makeBeforeBreak", true).toBool();
+    // láthatatlan falnál ennyi másodperc után a dekódolás is leáll (-1 = csak a konverzió áll)
+    const double hiddenStopSec = s.value("hiddenStopDecodeSec", -1).toDouble();
+    m_hiddenStopDecodeMs = hiddenStopSec < 0 ? -1 : int(qMin(hiddenStopSec, 86400.0) * 1000);
     qDebug() << "[loadFromIni] backgroundPath=" << backgroundFromIni;
 
     if (backgroundFromIni.isEmpty() && !backgroundCleared)
@@ -752,55 +1651,160 @@ void CameraWall::loadFromIni()
         applyBackgroundImage(QString());
 
     s.endGroup();
+
+    // feloldott stream-címek élettartama, ill. ennyi egymás utáni RTSP hiba után újrafeloldás (0 = ki)
+    m_uriTtlSec = int(qBound(0.1, s.value("Onvif/uriTtlHours", 24.0).toDouble(), 24.0 * 365) * 3600);
+    m_reresolveAfterFailures = qBound(0, s.value("Onvif/reresolveAfterFailures", 3).toInt(), 1000);
 }
 
-void CameraWall::saveCamerasToIni()
+void CameraWall::applyGlobalSettings()
 {
+    // a folyamat-szintű ütemezők beállításai: több fal mellett is egyszer, a falak létrehozása előtt
     QSettings s(Util::iniPath(), QSettings::IniFormat);
-    s.beginGroup("Cameras");
-    s.remove("");
-    s.setValue("count", cams.size());
 
-    auto aspectToStr = [](VideoTile::AspectMode m) -> QString
+    // Újrakapcsolódás – backoff, kézfogás-korlát, karantén (másodpercben, a jitter arány)
+    s.beginGroup("Reconnect");
+    ReconnectScheduler::Config rc;
+    rc.baseDelayMs = int(s.value("baseDelaySec", rc.baseDelayMs / 1000.0).toDouble() * 1000);
+    rc.maxDelayMs = int(s.value("maxDelaySec", rc.maxDelayMs / 1000.0).toDouble() * 1000);
+    rc.jitter = s.value("jitter", rc.jitter).toDouble();
+    rc.maxHandshakes = s.value("maxHandshakes", rc.maxHandshakes).toInt();
+    rc.handshakeTimeoutMs = int(s.value("handshakeTimeoutSec", rc.handshakeTimeoutMs / 1000.0).toDouble() * 1000);
+    rc.quarantineAfterMs = int(s.value("quarantineAfterSec", rc.quarantineAfterMs / 1000.0).toDouble() * 1000);
+    rc.quarantineProbeMs = int(s.value("quarantineProbeSec", rc.quarantineProbeMs / 1000.0).toDouble() * 1000);
+    s.endGroup();
+    ReconnectScheduler::instance().setConfig(rc);
+
+    // Befagyott streamek figyelése – csend után degradált, hosszabb csend után újraindítás
+    s.beginGroup("Watchdog");
+    StreamWatchdog::Config wc;
+    wc.enabled = s.value("enabled", wc.enabled).toBool();
+    wc.degradedAfterMs = int(s.value("degradedAfterSec", wc.degradedAfterMs / 1000.0).toDouble() * 1000);
+    wc.restartAfterMs = int(s.value("restartAfterSec", wc.restartAfterMs / 1000.0).toDouble() * 1000);
+    s.endGroup();
+    StreamWatchdog::instance().setConfig(wc);
+
+    // CPU-keret: felette a legkevésbé fontos csempék minősége lépcsőzetesen csökken
+    s.beginGroup("Quality");
+    QualityScheduler::Config qc;
+    qc.enabled = s.value("enabled", qc.enabled).toBool();
+    qc.cpuBudgetPercent = s.value("cpuBudgetPercent", qc.cpuBudgetPercent).toDouble();
+    qc.restoreBelowPercent = s.value("restoreBelowPercent", qc.restoreBelowPercent).toDouble();
+    qc.restoreHoldMs = int(s.value("restoreHoldSec", qc.restoreHoldMs / 1000.0).toDouble() * 1000);
+    qc.reducedFps = s.value("reducedFps", qc.reducedFps).toDouble();
+    qc.keyframeFps = s.value("keyframeFps", qc.keyframeFps).toDouble();
+    qc.settleMs = int(s.value("settleSec", qc.settleMs / 1000.0).toDouble() * 1000);
+    qc.minDropPercent = s.value("minDropPercent", qc.minDropPercent).toDouble();
+    s.endGroup();
+    QualityScheduler::instance().setConfig(qc);
+
+    // ONVIF kérések: egyszerre futó SOAP hívások felső korlátja (a többi sorban vár)
+    OnvifClient::instance().setMaxInFlight(s.value("Onvif/maxParallel", 8).toInt());
+}
+
+void CameraWall::saveCamerasToIni()
+{
+    // a közös listát csak az első fal írja; a többi az első szerkesztéskor saját csoportba vált
+    if (!ownsCameraList())
     {
-        switch (m)
-        {
-        case VideoTile::AspectMode::Stretch:
-            return "stretch";
-        case VideoTile::AspectMode::Fill:
-            return "fill";
-        case VideoTile::AspectMode::Fit:
-        default:
-            return "fit";
-        }
-    };
+        qDebug() << "[saveCamerasToIni] wall" << m_wallIndex << "forks the shared camera list";
+        m_camsGroup = wallGroup("Cameras");
+        if (actOwnCameras)
+            actOwnCameras->setChecked(true);
+    }
 
+    QSettings s(Util::iniPath(), QSettings::IniFormat);
+    s.beginGroup(m_camsGroup);
+    s.remove("");
+    s.setValue("count", cams.size());
     for (int i = 0; i < cams.size(); ++i)
     {
         s.beginGroup(QString("Camera%1").arg(i));
-        const Camera &c = cams[i];
-        s.setValue("name", c.name);
-        s.setValue("mode", c.mode == Camera::ONVIF ? "onvif" : "rtsp");
-        if (c.mode == Camera::RTSP)
-        {
-            s.setValue("rtsp", QString::fromUtf8(c.rtspManual.toEncoded()));
-        }
-        else
-        {
-            s.setValue("onvif_device_xaddr", c.onvifDeviceXAddr.toString());
-            s.setValue("onvif_media_xaddr", c.onvifMediaXAddr.toString());
-            s.setValue("onvif_user", c.onvifUser);
-            s.setValue("onvif_pass", c.onvifPass);
-            s.setValue("onvif_token", c.onvifChosenToken);
-            s.setValue("rtsp_cached", c.rtspUriCached);
-        }
+        writeCameraSettings(s, cams[i]);
+        s.endGroup();
+    }
+    s.endGroup();
+    s.sync();
 
-        // --- Aspect mód mentése ---
-        s.setValue("aspect", aspectToStr(c.aspectMode));
-        s.setValue("aspectRtsp", aspectToStr(c.aspectModeRtsp));
+    // a közös listát mutató többi fal ne maradjon régi másolaton
+    if (m_camsGroup == QLatin1String("Cameras"))
+        for (CameraWall *w : std::as_const(openWalls()))
+            if (w != this && !w->ownsCameraList())
+                w->reloadSharedCameras();
+}
+
+void CameraWall::saveCameraValidatedAt(int camIdx)
+{
+    if (camIdx < 0 || camIdx >= cams.size() || !ownsCameraList())
+        return;
+    QSettings s(Util::iniPath(), QSettings::IniFormat);
+    s.beginGroup(m_camsGroup);
+    if (s.value("count", 0).toInt() != cams.size())
+    {
+        s.endGroup();
+        saveCamerasToIni(); // a lista szerkezete eltér az ini-től: teljes mentés
+        return;
+    }
+    s.setValue(QString("Camera%1/rtsp_cached_at").arg(camIdx), cams[camIdx].uriValidatedAt.toString(Qt::ISODate));
+    s.endGroup();
+    s.sync();
+}
+
+bool CameraWall::ownsCameraList() const
+{
+    return m_camsGroup == wallGroup("Cameras");
+}
 
+void CameraWall::reloadSharedCameras()
+{
+    qDebug() << "[reloadSharedCameras] wall" << m_wallIndex;
+    QSettings s(Util::iniPath(), QSettings::IniFormat);
+    loadCamerasFromIni(s);
+    selectedIndex = -1;
+    rebuildTiles();
+}
+
+void CameraWall::setOwnCameraList(bool own)
+{
+    if (m_wallIndex == 0 || own == ownsCameraList())
+        return;
+    if (own)
+    {
+        // a jelenlegi (közös) lista másolata innentől ennek a falnak a sajátja
+        m_camsGroup = wallGroup("Cameras");
+        saveCamerasToIni();
+        return;
+    }
+    if (!Util::askOkCancel(this, "dlg.sharedcams", "Shared camera list",
+                           "msg.sharedcams", "Discard this screen's own camera list and show the shared list again?"))
+    {
+        actOwnCameras->setChecked(true);
+        return;
+    }
+    QSettings s(Util::iniPath(), QSettings::IniFormat);
+    s.remove(wallGroup("Cameras"));
+    s.sync();
+    reloadSharedCameras();
+}
+
+void CameraWall::saveCameraToIni(int camIdx)
+{
+    // csak egy kamera csoportja íródik újra (pl. háttérben frissült stream-cím);
+    // a közös listát olvasó fal nem ír: ugyanazt a címet az első fal is feloldja és menti
+    if (camIdx < 0 || camIdx >= cams.size() || !ownsCameraList())
+        return;
+    QSettings s(Util::iniPath(), QSettings::IniFormat);
+    s.beginGroup(m_camsGroup);
+    if (s.value("count", 0).toInt() != cams.size())
+    {
         s.endGroup();
+        saveCamerasToIni(); // a lista szerkezete eltér az ini-től: teljes mentés
+        return;
     }
+    s.beginGroup(QString("Camera%1").arg(camIdx));
+    s.remove("");
+    writeCameraSettings(s, cams[camIdx]);
+    s.endGroup();
     s.endGroup();
     s.sync();
 }
@@ -808,14 +1812,24 @@ void CameraWall::saveCamerasToIni()
 void CameraWall::saveViewToIni()
 {
     QSettings s(Util::iniPath(), QSettings::IniFormat);
-    s.beginGroup("View");
-    s.setValue("gridN", gridCols * 10 + gridRows); // pl. 32 = 3 oszlop × 2 sor
+    s.beginGroup(wallGroup("View"));
+    s.setValue("gridCols", gridCols);
+    s.setValue("gridRows", gridRows);
+    if (gridCols <= 9 && gridRows <= 9)
+        s.setValue("gridN", gridCols * 10 + gridRows); // régebbi verziókhoz (pl. 32 = 3 oszlop × 2 sor)
+    else
+        s.remove("gridN");
     s.setValue("fpsLimit15", m_limitFps15);
     s.setValue("autoRotate", m_autoRotate);
     s.setValue("keepAlive", m_keepBackgroundStreams);
     s.setValue("backgroundPath", backgroundPath);
     s.setValue("backgroundCleared", backgroundCleared);
     s.setValue("statusbarVisible", m_statusbarVisible);
+    s.setValue("repaintHz", m_repaintHz);
+    s.setValue("preconnectLeadMs", m_preconnectLeadMs);
+    s.setValue("streamBudget", m_streamBudget);
+    s.setValue("makeBeforeBreak", m_makeBeforeBreak);
+    s.setValue("hiddenStopDecodeSec", m_hiddenStopDecodeMs < 0 ? -1.0 : m_hiddenStopDecodeMs / 1000.0);
     s.endGroup();
     s.sync();
 }
@@ -836,6 +1850,11 @@ void CameraWall::updateMenuTexts()
         mHelp->setTitle(Language::instance().t("menu.help", "Help"));
     if (mGridMenu)
         mGridMenu->setTitle(Language::instance().t("menu.grid", "Grid"));
+    updateGridChecks(); // az egyéni rács menüpont szövege is nyelvfüggő
+    if (mRepaintMenu)
+        mRepaintMenu->setTitle(Language::instance().t("menu.repaint", "Repaint rate"));
+    if (actRepaintNow)
+        actRepaintNow->setText(Language::instance().t("menu.repaint.now", "Immediately (every frame)"));
     if (menuLanguage)
         menuLanguage->setTitle(Language::instance().t("menu.language", "Language"));
 
@@ -852,6 +1871,8 @@ void CameraWall::updateMenuTexts()
         actReorder->setText(Language::instance().t("menu.reorder", "Reorder cameras…"));
     if (actReload)
         actReload->setText(Language::instance().t("menu.reload", "Reload"));
+    if (actOwnCameras)
+        actOwnCameras->setText(Language::instance().t("menu.owncams", "Own camera list on this screen"));
     if (actExit)
         actExit->setText(Language::instance().t("menu.exit", "Exit"));
 
@@ -875,12 +1896,14 @@ void CameraWall::updateMenuTexts()
     if (actStatusbar)
         actStatusbar->setText(Language::instance().t(
             "menu.view.statusbar", "Show status bar"));
+    if (actStats)
+        actStats->setText(Language::instance().t("menu.stats", "Stream statistics…"));
 }
 
 void CameraWall::updateAppTitle()
 {
     const QString title = Language::instance().t("app.title", "IP Camera Wall");
-    setWindowTitle(title);
+    setWindowTitle(m_wallIndex == 0 ? title : QString("%1 (%2)").arg(title).arg(m_wallIndex + 1));
     QApplication::setApplicationDisplayName(title);
 }
 void CameraWall::focusShow(int camIdx)
@@ -972,6 +1995,7 @@ void CameraWall::focusShow(int camIdx)
     focusLayout->removeWidget(oldTile);
     oldTile->setParent(pageGrid);
     grid->addWidget(oldTile, focusRow, focusCol);
+    switchTileStream(oldTile, false);
 
     // 2) A placeholder-t átrakjuk az új csempe helyére (hogy tudjuk, hova térjünk vissza legközelebb)
     if (focusPlaceholder)
@@ -991,12 +2015,14 @@ void CameraWall::focusShow(int camIdx)
     newTile->setMinimumSize(0, 0);
     newTile->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     focusLayout->addWidget(newTile);
+    switchTileStream(newTile, true);
 
     // 4) Állapot frissítés
     focusTile = newTile;
     m_focusCamIdx = camIdx;
     focusRow = newRow;
     focusCol = newCol;
+    applySuspendPolicy();
 
     qDebug() << "[focusShow] updated m_focusCamIdx =" << m_focusCamIdx
              << " focusRow=" << focusRow << " focusCol=" << focusCol;
@@ -1004,13 +2030,41 @@ void CameraWall::focusShow(int camIdx)
 
 void CameraWall::updateGridChecks()
 {
-    // Első számjegy = oszlopok, második = sorok
-    if (actGrid22)
-        actGrid22->setChecked(gridCols == 2 && gridRows == 2);
-    if (actGrid33)
-        actGrid33->setChecked(gridCols == 3 && gridRows == 3);
-    if (actGrid32)
-        actGrid32->setChecked(gridCols == 3 && gridRows == 2); // 3 oszlop × 2 sor
+    bool preset = false;
+    for (QAction *a : std::as_const(gridPresetActions))
+    {
+        const bool on = (a->data().toSize() == QSize(gridCols, gridRows)); // oszlop × sor
+        a->setChecked(on);
+        preset = preset || on;
+    }
+    if (actGridCustom)
+    {
+        actGridCustom->setChecked(!preset);
+        actGridCustom->setText(preset ? Language::instance().t("menu.gridcustom", "Custom…")
+                                      : QString("%1 (%2×%3)…")
+                                            .arg(Language::instance().t("menu.gridcustom_named", "Custom"))
+                                            .arg(gridCols)
+                                            .arg(gridRows));
+    }
+}
+
+void CameraWall::setRepaintRate(int hz)
+{
+    m_repaintHz = qBound(0, hz, 240);
+    compositor->setRate(m_repaintHz);
+    compositor->resetStats();
+    updateRepaintChecks();
+    saveViewToIni();
+}
+
+void CameraWall::updateRepaintChecks()
+{
+    if (actRepaintNow)
+        actRepaintNow->setChecked(m_repaintHz == 0);
+    if (actRepaint30)
+        actRepaint30->setChecked(m_repaintHz == 30);
+    if (actRepaint60)
+        actRepaint60->setChecked(m_repaintHz == 60);
 }
 void CameraWall::chooseBackgroundImage()
 {
@@ -1130,3 +2184,119 @@ void CameraWall::applyStatusbarVisible()
     // ha látható, frissítsük a tipp-szöveget az aktuális nézet szerint
     showDefaultStatusHint();
 }
+
+void CameraWall::showStreamStats()
+{
+    QStringList lines;
+    for (const VideoTile *t : std::as_const(tiles))
+    {
+        if (!t)
+            continue;
+        lines << QString("%1: %2 %3 • %4 %5 • %6 %7 • %8 %9")
+                     .arg(t->name())
+                     .arg(Language::instance().t("stats.converted", "converted"))
+                     .arg(t->framesConverted())
+                     .arg(Language::instance().t("stats.dropped_mailbox", "superseded in queue"))
+                     .arg(t->framesDroppedInMailbox())
+                     .arg(Language::instance().t("stats.dropped_unpainted", "not painted"))
+                     .arg(t->framesDroppedUnpainted())
+                     .arg(Language::instance().t("stats.skipped_fps", "skipped by FPS limit"))
+                     .arg(t->framesSkippedByFps())
+               + QString(" • %1 %2")
+                     .arg(Language::instance().t("stats.skipped_suspended", "skipped while in background"))
+                     .arg(t->framesSkippedSuspended())
+               + QString(" • %1 %2 / %3 / %4 ms")
+                     .arg(Language::instance().t("stats.ttff", "first frame last/best/worst"))
+                     .arg(t->lastTimeToFirstFrameMs())
+                     .arg(t->bestTimeToFirstFrameMs())
+                     .arg(t->worstTimeToFirstFrameMs())
+               + QString(" • %1 %2 / %3")
+                     .arg(Language::instance().t("stats.stalls", "stalls/restarts"))
+                     .arg(t->stallsDetected())
+                     .arg(t->watchdogRestarts())
+               + QString(" • %1 %2")
+                     .arg(Language::instance().t("stats.tier", "quality tier"))
+                     .arg(QVariant::fromValue(t->qualityTier()).toString());
+    }
+    if (lines.isEmpty())
+        lines << Language::instance().t("status.count0", "0 camera");
+
+    const FramePool &pool = FramePool::instance();
+    lines << QString() << QString("%1: %2 %3 • %4 %5 • %6 %7 MB")
+                              .arg(Language::instance().t("stats.pool", "Frame buffer pool"))
+                              .arg(Language::instance().t("stats.pool_hits", "reused"))
+                              .arg(pool.hits())
+                              .arg(Language::instance().t("stats.pool_misses", "allocated"))
+                              .arg(pool.misses())
+                              .arg(Language::instance().t("stats.pool_idle", "idle"))
+                              .arg(pool.idleBytes() / (1024 * 1024));
+
+    const double cpu = QualityScheduler::instance().lastCpuPercent();
+    if (cpu >= 0.0)
+        lines << QString("%1: %2% / %3%")
+                     .arg(Language::instance().t("stats.cpu", "Process CPU / budget"))
+                     .arg(cpu, 0, 'f', 1)
+                     .arg(QualityScheduler::instance().config().cpuBudgetPercent, 0, 'f', 0);
+
+    const StreamHub &hub = StreamHub::instance();
+    lines << QString("%1: %2 %3 • %4 %5 • %6 %7 • %8 %9")
+                 .arg(Language::instance().t("stats.hub", "Decoded streams"))
+                 .arg(Language::instance().t("stats.hub_sources", "open"))
+                 .arg(hub.openSources())
+                 .arg(Language::instance().t("stats.hub_subscribers", "tiles fed"))
+                 .arg(hub.subscribers())
+                 .arg(Language::instance().t("stats.hub_shared", "shared"))
+                 .arg(hub.sharedSources())
+                 .arg(Language::instance().t("stats.hub_joins", "joined instead of opening"))
+                 .arg(hub.joins());
+
+    const QList<ReconnectScheduler::CameraStats> rs = ReconnectScheduler::instance().snapshot();
+    if (!rs.isEmpty())
+    {
+        lines << QString() << QString("%1 (%2 %3, %4 %5)")
+                                  .arg(Language::instance().t("stats.reconnect", "Reconnects"))
+                                  .arg(Language::instance().t("stats.handshakes", "handshaking"))
+                                  .arg(ReconnectScheduler::instance().activeHandshakes())
+                                  .arg(Language::instance().t("stats.queued", "queued"))
+                                  .arg(ReconnectScheduler::instance().queued());
+        for (const auto &c : rs)
+        {
+            QString line = QString("%1: %2 • %3 %4 • %5 %6 • %7 %8 s")
+                               .arg(c.name)
+                               .arg(QVariant::fromValue(c.state).toString())
+                               .arg(Language::instance().t("stats.attempts", "attempts"))
+                               .arg(c.attempts)
+                               .arg(Language::instance().t("stats.successes", "successful"))
+                               .arg(c.successes)
+                               .arg(Language::instance().t("stats.connected_for", "connected"))
+                               .arg(c.msInState[ReconnectScheduler::Connected] / 1000);
+            if (c.nextAttemptInMs >= 0)
+                line += QString(" • %1 %2 s").arg(Language::instance().t("stats.next_attempt", "next attempt in")).arg((c.nextAttemptInMs + 999) / 1000);
+            lines << line;
+        }
+    }
+
+    if (compositor && compositor->isActive())
+    {
+        const WallCompositor::Stats cs = compositor->stats();
+        lines << QString("%1 (%2 Hz): %3 %4 • %5 %6 / %7 • %8 %9 / %10 ms")
+                     .arg(Language::instance().t("stats.compositor", "Repaint"))
+                     .arg(compositor->rate())
+                     .arg(Language::instance().t("stats.ticks", "ticks"))
+                     .arg(cs.ticks)
+                     .arg(Language::instance().t("stats.tiles_per_tick", "tiles/tick avg/max"))
+                     .arg(cs.avgTiles(), 0, 'f', 1)
+                     .arg(cs.maxTiles)
+                     .arg(Language::instance().t("stats.paint_ms", "paint avg/max"))
+                     .arg(cs.avgPaintMs(), 0, 'f', 2)
+                     .arg(cs.maxPaintMs, 0, 'f', 2);
+    }
+
+    qDebug().noquote() << "[showStreamStats]\n" + lines.join('\n');
+
+    QMessageBox box(this);
+    box.setWindowTitle(Language::instance().t("dlg.stats", "Stream statistics"));
+    box.setText(lines.join('\n'));
+    box.setStandardButtons(QMessageBox::Ok);
+    box.exec();
+}
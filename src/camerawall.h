@@ -7,6 +7,7 @@
 #include <QTimer>
 #include <QVector>
 #include <QHash>
+#include <QSet>
 #include <QSettings>
 #include <QtMultimedia/QMediaPlayer>
 #include <QtMultimedia/QVideoSink>
@@ -16,6 +17,7 @@
 #include <QFileDialog>
 
 #include "videotile.h"
+#include "wallcompositor.h"
 #include "editcameradialog.h" // Camera struct itt van
 #include "reorderdialog.h"
 #include "language.h"
@@ -25,11 +27,24 @@ class CameraWall : public QMainWindow
 {
     Q_OBJECT
 public:
-    CameraWall();
+    // wallIndex: több képernyős módban a fal sorszáma (0 = az eredeti ini-csoportok)
+    explicit CameraWall(int wallIndex = 0);
+    ~CameraWall() override;
+
+    // a közös ütemezők ([Reconnect], [Watchdog], [Quality], Onvif/maxParallel) beállítása az ini-ből;
+    // folyamatonként egyszer, a falak létrehozása előtt
+    static void applyGlobalSettings();
 
 protected:
     void contextMenuEvent(QContextMenuEvent *e) override;
     void keyPressEvent(QKeyEvent *e) override;
+    void resizeEvent(QResizeEvent *e) override;
+    void changeEvent(QEvent *e) override; // kis méret
+    void showEvent(QShowEvent *e) override;
+    bool eventFilter(QObject *obj, QEvent *e) override; // az ablak Expose eseményei
+#ifdef Q_OS_WIN
+    bool nativeEvent(const QByteArray &eventType, void *message, qintptr *result) override; // zárolás, kijelző
+#endif
 
 private slots:
     // menü / működés
@@ -48,20 +63,76 @@ private slots:
     void chooseBackgroundImage();
     void clearBackgroundImage();
     void toggleStatusbarVisible();
+    void showStreamStats(); // csempénkénti konverziós/eldobási számlálók
 
 private:
     // layout / nézet
     int perPage() const { return gridRows * gridCols; }
+    int pageCount() const { return qMax(1, (int(cams.size()) + perPage() - 1) / perPage()); }
     void applyGridStretch();
-    void setGridN(int rc); // rc = rows*10 + cols, pl. 22, 33, 32
-    void rebuildTiles();
+    void setGrid(int cols, int rows); // tetszőleges oszlop × sor, legfeljebb kMaxGridDim
+    void onCustomGrid();              // párbeszédablak az egyéni mérethez
+    static constexpr int kMaxGridDim = 16;
+    void setRepaintRate(int hz); // 0 = azonnali, egyébként összevont festés ennyi Hz-en
+    void updateRepaintChecks();
+    void rebuildTiles(); // teljes: a csempe-készlet is újraépül
+    void showPage(int page); // lapozás: a készletben lévő csempék (streamek) újrahasznosulnak
+    void clearTilePool();
+    VideoTile *acquireTile(int camIdx); // készletből, vagy új csempe (rejtve) indított streammel
+    void preconnectPage(int page);
+    bool pageReady(int page) const;     // minden csempének van már képe
+    void onTileFirstFrame();
+    void enforceStreamBudget();         // a legrégebben látott háttér-streamek leállítása
+    int streamBudget() const;
+    void applySuspendPolicy();          // fókusz / háttér-oldalak / a fal láthatósága szerint felfüggeszt vagy folytat
     void enterFocus(int camIdx);
     void exitFocus();
 
     // adatok
-    QUrl playbackUrlFor(int camIdx, bool high, QString *errOut = nullptr);
+    // kamera saját korlátja, vagy a globális 15 FPS; kis rács-cellánál ennél is kevesebb (fókuszban nem)
+    double effectiveFpsFor(int camIdx, bool focus = false) const;
+    static double fpsCapForTilePx(const QSize &px); // 0 = nincs méret szerinti korlát
+    void applyFpsToTiles();                   // élő alkalmazás, stream-újraindítás nélkül
+    QUrl playbackUrlFor(int camIdx, bool high, QString *errOut = nullptr); // high: fókusz (fő stream)
+    void switchTileStream(VideoTile *tile, bool high); // rács ↔ fókusz stream-váltás
+    // ONVIF stream-URI feloldás a háttérben (nem blokkol); kész után a kamera csempéje újraindul
+    enum UriSlot
+    {
+        GridUri,  // rtspUriCached
+        HighUri,  // rtspUriCachedHigh
+        AutoUri   // autoUriCache[token]
+    };
+    // refreshMedia: a media címet is újrakéri (GetCapabilities), nem a tároltat használja
+    void requestOnvifUri(int camIdx, const QString &token, UriSlot slot, bool refreshMedia = false);
+    void onOnvifUriResolved(const QString &key, const QUrl &device, const QUrl &media, const QString &token,
+                            UriSlot slot, const QString &uri, const QString &err);
+    void refreshTileUrl(int camIdx); // a cache frissült: a csempe a (most már ismert) URL-re vált
+    QSet<QString> m_uriResolving;    // folyamatban lévő feloldások (eszköz|token|slot)
+
+    // URI-cache érvényessége: TTL lejártakor és ismétlődő RTSP hibák után háttérben újraellenőrzés
+    void revalidateCameraUris(int camIdx, bool refreshMedia);
+    void revalidateStaleUris();
+    void onTileConnectFailing(int consecutiveFailures);
+    void onTileQualityTierChanged(int tier); // SubStream szint: automatikus profilnál a legkisebb
+    QSize autoProfilePx(VideoTile *tile) const; // ehhez a mérethez választunk profilt
+    static bool hasProfileChoice(const Camera &c); // van-e kisebb profil a SubStream szinthez
+    QTimer uriRevalidateTimer;
+    int m_uriTtlSec{24 * 3600};
+    int m_reresolveAfterFailures{3};
+    // automatikus profil: a csempe eszköz-pixel méretét lefedő legkisebb profil URL-je
+    QUrl autoPlaybackUrlFor(int camIdx, const QSize &tilePx, QString *errOut = nullptr, QString *tokenOut = nullptr);
+    QSize expectedTilePx(bool focus) const;
+    void scheduleProfileReevaluation(); // késleltetve (átméretezés közben nem vált)
+    void reevaluateAutoProfiles();
+    QString wallGroup(const QString &group) const; // falanként külön ini-csoport (Wall<n>/…)
     void loadFromIni();
-    void saveCamerasToIni();
+    void loadCamerasFromIni(QSettings &s);
+    void saveCamerasToIni(); // további falnál az első mentés saját csoportba vált
+    void saveCameraValidatedAt(int camIdx); // csak a rtsp_cached_at kulcs (megerősített cím)
+    bool ownsCameraList() const; // a saját csoportját írja (az első fal: a közös [Cameras])
+    void reloadSharedCameras();  // a közös lista változott (az első fal mentett)
+    void setOwnCameraList(bool own);
+    void saveCameraToIni(int camIdx); // csak egy kamera csoportja
     void saveViewToIni();
 
     // nyelvi címkék
@@ -93,6 +164,10 @@ private:
     QVBoxLayout *focusLayout{};
     QWidget *focusPlaceholder{}; // a rácsban hagyott hely
 
+    // több képernyős mód: a fal sorszáma; a kameralista csoportja (saját, vagy az első falé közösen)
+    int m_wallIndex{0};
+    QString m_camsGroup{"Cameras"};
+
     // kamera/nézet állapot
     QVector<Camera> cams;
     QVector<VideoTile *> tiles;
@@ -100,6 +175,36 @@ private:
     int selectedIndex{-1};
     int currentPage{0};
     QTimer rotateTimer;
+    QTimer preconnectTimer;  // a forgatás előtt „lead” idővel indítja a következő oldalt
+    QTimer flipDeadline;     // ennyi ideig várunk a beérkező oldal első frame-jeire
+    int m_pendingPage{-1};   // lapozásra vár (még nincs minden csempének képe)
+    int m_preconnectedPage{-1}; // előre kapcsolt (rejtett, de aktív) oldal
+    int m_preconnectLeadMs{3000};
+    int m_streamBudget{0};   // egyszerre futó streamek felső korlátja (0 = 2 oldalnyi)
+    bool m_makeBeforeBreak{true}; // újrakapcsolódás a régi stream mellett, fekete rés nélkül
+
+    // a fal egésze nem látszik – okonként egy bit; bármelyik elég a felfüggesztéshez
+    enum HiddenReason
+    {
+        HiddenMinimized = 0x01,
+        HiddenNotExposed = 0x02,    // teljesen takarva / nem kirajzolható
+        HiddenDisplayOff = 0x04,    // a kijelző kikapcsolt (energiagazdálkodás)
+        HiddenSessionLocked = 0x08, // zárolt munkamenet
+        HiddenAppHidden = 0x10      // az alkalmazás rejtve / felfüggesztve
+    };
+    void setHiddenReason(HiddenReason r, bool on);
+    void registerVisibilityNotifications(); // Expose-figyelés + natív értesítések, egyszer
+    int m_hiddenReasons{0};
+    int m_hiddenStopDecodeMs{-1};      // ennyi rejtettség után a dekódolás is leáll (-1 = soha)
+    bool m_hiddenDecodeStopped{false};
+    QTimer hiddenStopTimer;
+    bool m_visibilityHooked{false};
+    void *m_powerNotify{}; // Windows: HPOWERNOTIFY
+    QHash<int, VideoTile *> tilePool; // kamera-index → csempe (futó stream)
+    QHash<int, quint64> tileLastShown; // LRU: melyik lapozáskor volt utoljára látható
+    quint64 m_pageSerial{0};
+    QTimer profileTimer;                       // automatikus profil újraértékelése
+    QHash<VideoTile *, QString> autoTokenOfTile; // csempénként az éppen játszott profil
 
     // ÚJ: téglalap rács
     int gridRows{2};
@@ -109,6 +214,10 @@ private:
     bool m_autoRotate{true};
     bool m_keepBackgroundStreams{true};
     bool m_statusbarVisible{true};
+    int m_repaintHz{60};
+
+    // összevont újrarajzolás (a csempék frame-jei ütemenként egyszerre festődnek)
+    WallCompositor *compositor{};
 
     // fókusz állapot
     int m_focusCamIdx{-1};
@@ -117,12 +226,16 @@ private:
 
     // menük
     QAction *actFps{}, *actFull{}, *actEdit{}, *actKeepAlive{}, *actAutoRotate{},
-        *actGrid22{}, *actGrid33{}, *actGrid32{}, *actReorder{};
+        *actGridCustom{}, *actReorder{};
+    QList<QAction *> gridPresetActions; // 2×2 … 8×8 (data: QSize oszlop × sor)
     QAction *actLangHu{}, *actLangEn{}, *actBackground{}, *actBackgroundClear{}, *actStatusbar{};
 
-    QMenu *mCams{}, *mView{}, *mHelp{}, *menuLanguage{}, *mGridMenu{};
-    QActionGroup *gridGroup{}, *langGroup{};
-    QAction *actAdd{}, *actRemove{}, *actClear{}, *actReload{}, *actExit{}, *actAbout{};
+    QAction *actRepaintNow{}, *actRepaint30{}, *actRepaint60{};
+
+    QMenu *mCams{}, *mView{}, *mHelp{}, *menuLanguage{}, *mGridMenu{}, *mRepaintMenu{};
+    QActionGroup *gridGroup{}, *langGroup{}, *repaintGroup{};
+    QAction *actAdd{}, *actRemove{}, *actClear{}, *actReload{}, *actExit{}, *actAbout{}, *actStats{};
+    QAction *actOwnCameras{};
 
     // ESC gyorsbillentyű
     QShortcut *shortcutEsc{nullptr};
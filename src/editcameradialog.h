@@ -6,11 +6,15 @@
 #include <QComboBox>
 #include <QLabel>
 #include <QDialogButtonBox>
+#include <QCheckBox>
+#include <QPushButton>
 
 #include "util.h"
 #include "onvifclient.h"
+#include "onvifdiscovery.h"
 #include "language.h"
 #include "videotile.h"
+#include "streamsource.h"
 
 // A teljes app Camera modellje
 struct Camera
@@ -24,22 +28,84 @@ struct Camera
 
     // RTSP (kézi)
     QUrl rtspManual;
+    QUrl rtspManualHigh; // fókusz nézet (fő stream); üres = ugyanaz, mint a rácsban
 
     // ONVIF
     QUrl onvifDeviceXAddr; // http://IP/onvif/device_service
     QUrl onvifMediaXAddr;  // GetCapabilities-ből
     QString onvifUser, onvifPass;
 
-    // Mostantól EGY választott profil tokenjét használjuk mindenhol
+    // rács: a választott (jellemzően kis felbontású al-) profil tokenje
     QString onvifChosenToken;
+    // fókusz nézet: fő stream profil tokenje; üres = ugyanaz, mint a rácsban
+    QString onvifHighToken;
 
-    // Cache-elt (feloldott) RTSP URI (ha már lekértük)
+    // automatikus profilválasztás: a csempe eszköz-pixel méretét lefedő legkisebb profil
+    bool onvifAutoProfile = false;
+    QList<OnvifProfile> onvifProfiles;     // a kamera profiljai (felbontással), ini-ben is
+    QHash<QString, QString> autoUriCache;  // token → feloldott URI (csak memóriában)
+
+    // Cache-elt (feloldott) RTSP URI-k (ha már lekértük)
     QString rtspUriCached;
+    QString rtspUriCachedHigh;
+    QDateTime uriValidatedAt; // utolsó sikeres feloldás/ellenőrzés (TTL: Onvif/uriTtlHours)
 
     VideoTile::AspectMode aspectMode = VideoTile::AspectMode::Fit;
     VideoTile::AspectMode aspectModeRtsp = VideoTile::AspectMode::Fit;
+
+    // kameránkénti FPS-korlát (0 = a globális „FPS limit 15” beállítás érvényes)
+    int maxFps = 0;
+
+    // lejátszó háttér: QMediaPlayer (alap) vagy közvetlen libav, ez utóbbihoz FFmpeg-opciók („kulcs=érték;…”)
+    StreamSource::Backend backend = StreamSource::QtMultimedia;
+    QString avOptions;
 };
 
+// A csempét (eszköz-pixel) lefedő legkisebb felbontású profil tokenje; ha egyik sem fedi le,
+// a legnagyobbé. Felbontás nélküli profilt csak végső esetben választunk.
+inline QString autoProfileToken(const Camera &c, const QSize &tilePx)
+{
+    const OnvifProfile *best = nullptr;    // legkisebb lefedő
+    const OnvifProfile *largest = nullptr; // tartalék
+    auto area = [](const OnvifProfile &p)
+    { return qint64(p.resolution.width()) * p.resolution.height(); };
+    for (const OnvifProfile &p : c.onvifProfiles)
+    {
+        if (p.token.isEmpty() || !p.resolution.isValid())
+            continue;
+        if (!largest || area(p) > area(*largest))
+            largest = &p;
+        const bool covers = p.resolution.width() >= tilePx.width() && p.resolution.height() >= tilePx.height();
+        if (covers && (!best || area(p) < area(*best)))
+            best = &p;
+    }
+    if (best)
+        return best->token;
+    if (largest)
+        return largest->token;
+    return c.onvifChosenToken;
+}
+
+// Van-e a rácsétól eltérő fő stream a fókusz nézethez?
+inline bool hasHighStream(const Camera &c)
+{
+    if (c.mode == Camera::RTSP)
+        return c.rtspManualHigh.isValid() && !c.rtspManualHigh.isEmpty() && c.rtspManualHigh != c.rtspManual;
+    return !c.onvifHighToken.isEmpty() && c.onvifHighToken != c.onvifChosenToken;
+}
+
+// Ugyanazt a streamet írja-e le a két beállítás? (ha igen, nem kell újrakapcsolódni)
+inline bool sameStreamSource(const Camera &a, const Camera &b)
+{
+    if (a.mode != b.mode)
+        return false;
+    if (a.mode == Camera::RTSP)
+        return a.rtspManual == b.rtspManual && a.rtspManualHigh == b.rtspManualHigh;
+    return a.onvifDeviceXAddr == b.onvifDeviceXAddr && a.onvifUser == b.onvifUser &&
+           a.onvifPass == b.onvifPass && a.onvifChosenToken == b.onvifChosenToken &&
+           a.onvifHighToken == b.onvifHighToken && a.onvifAutoProfile == b.onvifAutoProfile;
+}
+
 class EditCameraDialog : public QDialog
 {
     Q_OBJECT
@@ -53,22 +119,39 @@ public:
     int aspectModeRtspInt() const;       // 0/1/2
 
 private:
-    void fetchProfiles();
+    void fetchProfiles();                               // aszinkron: GetCapabilities → GetProfiles
+    void applyProfiles(const QList<OnvifProfile> &profs); // a lekért profilok a listákba
+    void clearProfiles();                               // más eszközre váltáskor: profilok, tokenek törlése
+    void startDiscovery();                              // WS-Discovery keresés a hálózaton
+    void useDiscovered(int index);                      // a kiválasztott találat adatai az űrlapba
+    QString discoveredText(const OnvifDiscovery::Device &d) const;
 
 private:
     QTabWidget *tabs{};
     // RTSP tab
-    QLineEdit *nameRtsp{}, *urlRtsp{};
+    QLineEdit *nameRtsp{}, *urlRtsp{}, *urlRtspHigh{};
     // ONVIF tab
     QLineEdit *nameOnvif{}, *ip{}, *user{}, *pass{};
     QSpinBox *port{};
-    QComboBox *profileCombo{}; // egyetlen legördülő: a választott profil
+    QComboBox *profileCombo{};     // rács: a választott (al-)profil
+    QComboBox *profileHighCombo{}; // fókusz: fő profil (0. elem = „ugyanaz, mint a rácsban”)
+    QCheckBox *cbAutoProfile{};    // profil a csempe mérete szerint
     QComboBox *cbAspect = nullptr;
     QComboBox *cbAspectRtsp = nullptr;
+    QSpinBox *spFps = nullptr;
+    QSpinBox *spFpsRtsp = nullptr;
+    QComboBox *cbBackend{}, *cbBackendRtsp{};  // lejátszó háttér (tabonként)
+    QLineEdit *avOptions{}, *avOptionsRtsp{};  // FFmpeg-opciók (csak libav háttérnél)
     QLabel *info{};
+    QComboBox *discoveredCombo{};
+    QPushButton *btnDiscover{};
+    OnvifDiscovery *discovery{};
 
     QList<OnvifProfile> fetchedProfiles;
     QString lastMediaXAddr;
+    OnvifClient::RequestId fetchRequest{0}; // futó profil-lekérés (0 = nincs)
     QString cachedUri; // best-effort előtöltés
     QString preselectedToken;
+    QString preselectedHighToken;
+    QList<OnvifProfile> previousProfiles; // ha most nem sikerül lekérni, ezek maradnak
 };
@@ -0,0 +1,344 @@
+#include "frameconverter.h"
+#include "yuvconvert.h"
+#include "framepool.h"
+
+#include <QThreadPool>
+#include <QThread>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QDebug>
+
+FrameConverter::FrameConverter(QObject *parent)
+    : QObject(parent)
+{
+    static const bool logged = []
+    {
+        qDebug() << "[FrameConverter] YUV kernel:" << Yuv::activeKernel();
+        return true;
+    }();
+    Q_UNUSED(logged);
+}
+
+FrameConverter::~FrameConverter()
+{
+    shutdown();
+}
+
+QThreadPool *FrameConverter::pool()
+{
+    // saját készlet, hogy a hosszú konverziók ne foglalják a globális pool-t
+    static QThreadPool *p = []
+    {
+        auto *tp = new QThreadPool;
+        tp->setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+        tp->setExpiryTimeout(30000);
+        return tp;
+    }();
+    return p;
+}
+
+void FrameConverter::submit(const QVideoFrame &frame)
+{
+    if (!frame.isValid())
+        return;
+
+    m_submitted.fetch_add(1, std::memory_order_relaxed);
+
+    bool startWorker = false;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_closing)
+            return;
+        if (m_hasPending)
+            m_droppedMailbox.fetch_add(1, std::memory_order_relaxed); // a régi még el sem indult
+        m_pending = frame;
+        m_pendingGen = m_generation;
+        m_hasPending = true;
+        if (!m_running)
+        {
+            m_running = true;
+            startWorker = true;
+        }
+    }
+
+    if (startWorker)
+        pool()->start([this]
+                      { runWorker(); });
+}
+
+void FrameConverter::setTarget(const ConvertTarget &t)
+{
+    QMutexLocker lock(&m_mutex);
+    m_target = t;
+}
+
+bool FrameConverter::takeImage(QImage &out, ConvertTarget *madeFor)
+{
+    QMutexLocker lock(&m_mutex);
+    m_notified = false;
+    if (!m_hasReady)
+        return false;
+    out = std::move(m_ready);
+    if (madeFor)
+        *madeFor = m_readyTarget;
+    m_ready = QImage();
+    m_hasReady = false;
+    return true;
+}
+
+void FrameConverter::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    ++m_generation;
+    m_pending = QVideoFrame();
+    m_hasPending = false;
+    m_ready = QImage();
+    m_hasReady = false;
+}
+
+void FrameConverter::shutdown()
+{
+    QMutexLocker lock(&m_mutex);
+    m_closing = true;
+    m_pending = QVideoFrame();
+    m_hasPending = false;
+    while (m_running)
+        m_idle.wait(&m_mutex);
+    m_ready = QImage();
+    m_hasReady = false;
+}
+
+void FrameConverter::runWorker()
+{
+    for (;;)
+    {
+        QVideoFrame frame;
+        ConvertTarget target;
+        quint64 gen = 0;
+        {
+            QMutexLocker lock(&m_mutex);
+            if (!m_hasPending || m_closing)
+            {
+                m_running = false;
+                m_idle.wakeAll();
+                return;
+            }
+            frame = m_pending;
+            gen = m_pendingGen;
+            target = m_target;
+            m_pending = QVideoFrame();
+            m_hasPending = false;
+        }
+
+        QElapsedTimer cost; // a minőség-ütemező csempénkénti költségbecsléséhez
+        cost.start();
+        QImage img = convert(frame, target);
+        frame = QVideoFrame(); // a dekóder puffere minél hamarabb szabaduljon
+        m_convertNs.fetch_add(quint64(cost.nsecsElapsed()), std::memory_order_relaxed);
+        if (img.isNull())
+            continue;
+
+        bool notify = false;
+        {
+            QMutexLocker lock(&m_mutex);
+            if (m_closing || gen != m_generation)
+                continue; // közben clear() volt: elavult eredmény
+            if (m_hasReady)
+                m_droppedReady.fetch_add(1, std::memory_order_relaxed);
+            m_ready = std::move(img);
+            m_readyTarget = target;
+            m_hasReady = true;
+            if (!m_notified)
+            {
+                m_notified = true;
+                notify = true;
+            }
+        }
+        m_converted.fetch_add(1, std::memory_order_relaxed);
+
+        // a jel sorba állítva jut el a GUI szálra (a konverter ott él)
+        if (notify)
+            emit imageReady();
+    }
+}
+
+namespace
+{
+    // az FFmpeg által adott 4:2:0 formátumok síkjai (YUVJ420P = YUV420P teljes tartománnyal)
+    bool yuvPlanesFor(const QVideoFrame &f, Yuv::Planes &p, Yuv::ColorInfo &ci)
+    {
+        p = Yuv::Planes{};
+        p.width = f.width();
+        p.height = f.height();
+        p.y = f.bits(0);
+        p.yStride = f.bytesPerLine(0);
+
+        switch (f.pixelFormat())
+        {
+        case QVideoFrameFormat::Format_YUV420P:
+        case QVideoFrameFormat::Format_YV12:
+        {
+            const bool yv12 = (f.pixelFormat() == QVideoFrameFormat::Format_YV12); // Y, V, U sorrend
+            p.layout = Yuv::Layout::I420;
+            p.u = f.bits(yv12 ? 2 : 1);
+            p.uStride = f.bytesPerLine(yv12 ? 2 : 1);
+            p.v = f.bits(yv12 ? 1 : 2);
+            p.vStride = f.bytesPerLine(yv12 ? 1 : 2);
+            break;
+        }
+        case QVideoFrameFormat::Format_NV12:
+        case QVideoFrameFormat::Format_NV21:
+            p.layout = Yuv::Layout::NV12;
+            p.u = f.bits(1);
+            p.uStride = f.bytesPerLine(1);
+            p.swapUV = (f.pixelFormat() == QVideoFrameFormat::Format_NV21);
+            break;
+        default:
+            return false;
+        }
+        if (!p.y || !p.u || (p.layout == Yuv::Layout::I420 && !p.v))
+            return false;
+
+        const QVideoFrameFormat fmt = f.surfaceFormat();
+        ci.fullRange = (fmt.colorRange() == QVideoFrameFormat::ColorRange_Full);
+        switch (fmt.colorSpace())
+        {
+        case QVideoFrameFormat::ColorSpace_BT709:
+            ci.matrix = Yuv::Matrix::BT709;
+            break;
+        case QVideoFrameFormat::ColorSpace_BT601:
+            ci.matrix = Yuv::Matrix::BT601;
+            break;
+        default:
+            // ismeretlen: HD felett BT.709, SD-n BT.601 (FFmpeg is így tippel)
+            ci.matrix = (p.height > 576) ? Yuv::Matrix::BT709 : Yuv::Matrix::BT601;
+            break;
+        }
+        return true;
+    }
+}
+
+QImage FrameConverter::convert(const QVideoFrame &frame, const ConvertTarget &t)
+{
+    QVideoFrame f(frame);
+    if (!f.map(QVideoFrame::ReadOnly))
+        return QImage();
+
+    // gyors út: YUV → RGB32 + skálázás + vágás egyetlen menetben, a célméretre;
+    // csak a látható forrás-téglalap (viewport, Fill-vágás) sorai/oszlopai kerülnek feldolgozásra
+    Yuv::Planes planes;
+    Yuv::ColorInfo color;
+    const bool sized = t.size.isValid() && !t.size.isEmpty();
+    if (yuvPlanesFor(f, planes, color))
+    {
+        const QSize srcSize(planes.width, planes.height);
+        const QRectF region = sourceRegion(srcSize, t);
+        QSize outSize = region.size().toSize().expandedTo(QSize(1, 1));
+        if (sized)
+            outSize = (t.mode == ConvertTarget::Fit)
+                          ? region.size().scaled(QSizeF(t.size), Qt::KeepAspectRatio).toSize().expandedTo(QSize(1, 1))
+                          : t.size;
+
+        // a puffer a készletből jön, és a kép utolsó másolatával együtt oda is tér vissza
+        QImage out = FramePool::instance().acquire(outSize);
+        const Yuv::SourceRect src{region.x(), region.y(), region.width(), region.height()};
+        if (!out.isNull() &&
+            Yuv::convertScaled(planes, color, src, reinterpret_cast<uint32_t *>(out.bits()),
+                               int(out.bytesPerLine()), out.width(), out.height()))
+        {
+            f.unmap();
+            if (sized)
+                out.setDevicePixelRatio(t.dpr);
+            return out;
+        }
+    }
+
+    // általános út (egyéb pixelformátumok, hardveres frame-ek): Qt konverzió,
+    // majd előbb vágunk, hogy a formátumváltás és a skálázás már csak a látható részen fusson
+    QImage img = f.toImage();
+    f.unmap();
+
+    if (img.isNull())
+        return QImage();
+
+    const QRect region = sourceRegion(img.size(), t).toAlignedRect() & img.rect();
+    if (region != img.rect())
+        img = img.copy(region);
+    ConvertTarget rest = t;
+    rest.viewport = QRectF(0, 0, 1, 1);
+    return scaleForTarget(img.convertToFormat(QImage::Format_RGB32), rest);
+}
+
+QRectF FrameConverter::sourceRegion(const QSize &src, const ConvertTarget &t)
+{
+    const QRectF full(QPointF(0, 0), QSizeF(src));
+    QRectF region(t.viewport.x() * src.width(), t.viewport.y() * src.height(),
+                  t.viewport.width() * src.width(), t.viewport.height() * src.height());
+    region = region.intersected(full);
+    if (region.width() < 1.0 || region.height() < 1.0)
+        region = full;
+
+    if (t.mode == ConvertTarget::Fill && t.size.isValid() && !t.size.isEmpty())
+        region = fillCropRect(region, t.size);
+    return region;
+}
+
+QRectF FrameConverter::fillCropRect(const QRectF &src, const QSize &dst)
+{
+    if (src.isEmpty() || dst.isEmpty())
+        return src;
+
+    const double sAspect = src.width() / src.height();
+    const double dAspect = double(dst.width()) / dst.height();
+    if (sAspect > dAspect)
+    {
+        // Forrás szélesebb: magasság kitölt, szélességből vágunk
+        const double newW = src.height() * dAspect;
+        return QRectF(src.x() + (src.width() - newW) / 2.0, src.y(), newW, src.height());
+    }
+    // Forrás magasabb: szélesség kitölt, magasságból vágunk
+    const double newH = src.width() / dAspect;
+    return QRectF(src.x(), src.y() + (src.height() - newH) / 2.0, src.width(), newH);
+}
+
+QRect FrameConverter::fillCropRect(const QSize &src, const QSize &dst)
+{
+    if (src.isEmpty() || dst.isEmpty())
+        return QRect(QPoint(0, 0), src);
+
+    const double sAspect = double(src.width()) / src.height();
+    const double dAspect = double(dst.width()) / dst.height();
+    if (sAspect > dAspect)
+    {
+        // Forrás szélesebb: magasság kitölt, szélességből vágunk
+        const int newW = qBound(1, qRound(src.height() * dAspect), src.width());
+        return QRect((src.width() - newW) / 2, 0, newW, src.height());
+    }
+    // Forrás magasabb: szélesség kitölt, magasságból vágunk
+    const int newH = qBound(1, qRound(src.width() / dAspect), src.height());
+    return QRect(0, (src.height() - newH) / 2, src.width(), newH);
+}
+
+QImage FrameConverter::scaleForTarget(const QImage &src, const ConvertTarget &t)
+{
+    if (src.isNull() || !t.size.isValid() || t.size.isEmpty())
+        return src; // nincs ismert célméret: teljes felbontás
+
+    QImage out;
+    switch (t.mode)
+    {
+    case ConvertTarget::Stretch:
+        out = src.scaled(t.size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        break;
+    case ConvertTarget::Fill:
+        out = src.copy(fillCropRect(src.size(), t.size))
+                  .scaled(t.size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        break;
+    case ConvertTarget::Fit:
+    default:
+        out = src.scaled(t.size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        break;
+    }
+    out.setDevicePixelRatio(t.dpr);
+    return out;
+}
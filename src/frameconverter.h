@@ -0,0 +1,110 @@
+#pragma once
+#include <QObject>
+#include <QImage>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QtMultimedia/QVideoFrame>
+#include <atomic>
+
+class QThreadPool;
+
+// Cél-leírás: a konverter ekkora (eszköz-pixel) képet állít elő, a csempe képarány-módja szerint
+struct ConvertTarget
+{
+    enum Mode
+    {
+        Fit = 0,     // teljes kép, oldalarány megőrzésével (letterbox)
+        Stretch = 1, // torzítva kitölt
+        Fill = 2     // oldalarányosan kitölt, a széleket levágja
+    };
+
+    QSize size;         // eszköz-pixelben; érvénytelen = nincs skálázás (teljes felbontás)
+    Mode mode = Fit;
+    qreal dpr = 1.0;    // a kimeneti kép devicePixelRatio-ja
+    QRectF viewport{0.0, 0.0, 1.0, 1.0}; // a forrás látható része, normalizálva (digitális zoom)
+
+    bool operator==(const ConvertTarget &o) const
+    {
+        return size == o.size && mode == o.mode && qFuzzyCompare(dpr, o.dpr) && viewport == o.viewport;
+    }
+    bool operator!=(const ConvertTarget &o) const { return !(*this == o); }
+};
+
+/*
+ * Képkonverter egy csempéhez.
+ * - A QVideoSink callback (GUI szál) csak beteszi a frame-et a „postaládába” (submit).
+ * - A konverzió egy közös szálkészleten fut; ha a worker még dolgozik, az újabb
+ *   frame felülírja a várakozót (latest-frame-wins), a régi eldobódik.
+ * - A GUI szál az imageReady() jelre átveszi a kész képet (takeImage) és update()-et hív.
+ * - A kimenet már a csempe méretére skálázott (setTarget), így a paintEvent csak „blit”-el.
+ */
+class FrameConverter : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FrameConverter(QObject *parent = nullptr);
+    ~FrameConverter() override;
+
+    // GUI szál: új frame a postaládába (a várakozó régit felülírja)
+    void submit(const QVideoFrame &frame);
+
+    // cél méret/mód beállítása (a következő konvertált frame-től érvényes)
+    void setTarget(const ConvertTarget &t);
+
+    // GUI szál: kész kép átvétele; false, ha nincs új kép. madeFor: milyen célra készült
+    bool takeImage(QImage &out, ConvertTarget *madeFor = nullptr);
+
+    // közös skálázó: a worker és a csempe (átméretezés utáni cache) is ezt használja;
+    // src-ben a viewport már alkalmazva van, itt csak a mód szerinti vágás + skálázás történik
+    static QImage scaleForTarget(const QImage &src, const ConvertTarget &t);
+    // Fill módban a forrás látható (középre igazított) része
+    static QRect fillCropRect(const QSize &src, const QSize &dst);
+    static QRectF fillCropRect(const QRectF &src, const QSize &dst);
+    // a forrásból ténylegesen konvertálandó terület (viewport + Fill-vágás), pixelben
+    static QRectF sourceRegion(const QSize &src, const ConvertTarget &t);
+
+    // várakozó és kész kép eldobása (pl. URL-váltás, stop) – a futó konverzió eredménye is elvész
+    void clear();
+
+    // megvárja a futó konverziót, utána már nem jön imageReady()
+    void shutdown();
+
+    // számlálók (bármely szálról olvashatók)
+    quint64 submittedFrames() const { return m_submitted.load(); }
+    quint64 convertedFrames() const { return m_converted.load(); }
+    quint64 droppedInMailbox() const { return m_droppedMailbox.load(); } // konverzió előtt felülírva
+    quint64 droppedUnpainted() const { return m_droppedReady.load(); }   // konvertálva, de ki sem rajzolva
+    quint64 convertNanos() const { return m_convertNs.load(); }          // konverzióval töltött idő összesen
+
+signals:
+    void imageReady();
+
+private:
+    void runWorker(); // szálkészleten fut
+    static QImage convert(const QVideoFrame &frame, const ConvertTarget &t);
+    static QThreadPool *pool();
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_idle;
+
+    QVideoFrame m_pending; // postaláda (max. 1 elem)
+    bool m_hasPending{false};
+    quint64 m_pendingGen{0};
+
+    QImage m_ready; // kész, még át nem vett kép
+    ConvertTarget m_readyTarget;
+    bool m_hasReady{false};
+
+    ConvertTarget m_target; // m_mutex védi
+
+    quint64 m_generation{0}; // clear() növeli: a régebbi eredmények eldobódnak
+    bool m_running{false};   // fut-e worker a szálkészleten
+    bool m_notified{false};  // imageReady() már ki van küldve, a GUI még nem vette át
+    bool m_closing{false};
+
+    std::atomic<quint64> m_submitted{0};
+    std::atomic<quint64> m_converted{0};
+    std::atomic<quint64> m_droppedMailbox{0};
+    std::atomic<quint64> m_droppedReady{0};
+    std::atomic<quint64> m_convertNs{0};
+};
@@ -0,0 +1,139 @@
+#include "framepool.h"
+
+#include <QMutexLocker>
+#include <new>
+
+namespace
+{
+    constexpr size_t kAlign = 64;     // cache-sor / AVX-512 igazítás
+    constexpr qsizetype kHeader = 64; // a puffer elején: méretosztály (az igazítás megmarad)
+
+    uchar *allocBuffer(qsizetype bytes)
+    {
+        void *p = ::operator new(size_t(kHeader + bytes), std::align_val_t(kAlign), std::nothrow);
+        if (!p)
+            return nullptr;
+        *static_cast<qsizetype *>(p) = bytes;
+        return static_cast<uchar *>(p) + kHeader;
+    }
+
+    void freeBuffer(uchar *data)
+    {
+        ::operator delete(data - kHeader, std::align_val_t(kAlign));
+    }
+
+    qsizetype classOf(const uchar *data)
+    {
+        return *reinterpret_cast<const qsizetype *>(data - kHeader);
+    }
+}
+
+FramePool &FramePool::instance()
+{
+    // szándékosan nem szabadul fel: a képek a statikus destruktorok után is visszaadhatják a puffert
+    static FramePool *p = new FramePool;
+    return *p;
+}
+
+qsizetype FramePool::sizeClass(qsizetype bytes)
+{
+    // legfeljebb ~6% veszteség, cserébe a közeli méretek (pár pixeles átméretezés) közös osztályba esnek
+    qsizetype top = 1;
+    while ((top << 1) <= bytes)
+        top <<= 1;
+    const qsizetype granule = qMax<qsizetype>(64 * 1024, top / 16);
+    return (bytes + granule - 1) / granule * granule;
+}
+
+QImage FramePool::acquire(const QSize &size)
+{
+    if (size.isEmpty())
+        return QImage();
+
+    const qsizetype bpl = (qsizetype(size.width()) * 4 + qsizetype(kAlign) - 1) / qsizetype(kAlign) * qsizetype(kAlign);
+    const qsizetype cls = sizeClass(bpl * size.height());
+
+    uchar *data = nullptr;
+    {
+        QMutexLocker lock(&m_mutex);
+        auto it = m_free.find(cls);
+        if (it != m_free.end() && !it->isEmpty())
+        {
+            data = it->takeLast();
+            m_idleBytes -= cls;
+            m_freeOrder.removeOne(cls);
+        }
+    }
+
+    if (data)
+    {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        data = allocBuffer(cls);
+        if (!data)
+            return QImage(size, QImage::Format_RGB32); // nincs memória a készlethez: sima kép
+    }
+    m_liveBytes.fetch_add(cls, std::memory_order_relaxed);
+
+    return QImage(data, size.width(), size.height(), bpl, QImage::Format_RGB32,
+                  &FramePool::releaseCallback, data);
+}
+
+void FramePool::releaseCallback(void *info)
+{
+    auto *data = static_cast<uchar *>(info);
+    instance().release(Buffer{data, classOf(data)});
+}
+
+void FramePool::release(const Buffer &b)
+{
+    m_liveBytes.fetch_sub(b.bytes, std::memory_order_relaxed);
+
+    QMutexLocker lock(&m_mutex);
+    m_free[b.bytes].append(b.data);
+    m_freeOrder.append(b.bytes);
+    m_idleBytes += b.bytes;
+    freeExcessLocked();
+}
+
+void FramePool::freeExcessLocked()
+{
+    while (m_idleBytes > m_maxIdleBytes && !m_freeOrder.isEmpty())
+    {
+        const qsizetype cls = m_freeOrder.takeFirst();
+        QList<uchar *> &list = m_free[cls];
+        if (list.isEmpty())
+            continue;
+        freeBuffer(list.takeFirst()); // az osztály leghidegebb puffere
+        m_idleBytes -= cls;
+        if (list.isEmpty())
+            m_free.remove(cls);
+    }
+}
+
+void FramePool::trim()
+{
+    QMutexLocker lock(&m_mutex);
+    for (auto it = m_free.begin(); it != m_free.end(); ++it)
+        for (uchar *data : std::as_const(it.value()))
+            freeBuffer(data);
+    m_free.clear();
+    m_freeOrder.clear();
+    m_idleBytes = 0;
+}
+
+void FramePool::setMaxIdleBytes(qint64 bytes)
+{
+    QMutexLocker lock(&m_mutex);
+    m_maxIdleBytes = qMax<qint64>(0, bytes);
+    freeExcessLocked();
+}
+
+qint64 FramePool::idleBytes() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_idleBytes;
+}
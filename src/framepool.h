@@ -0,0 +1,61 @@
+#pragma once
+#include <QImage>
+#include <QMutex>
+#include <QHash>
+#include <QList>
+#include <atomic>
+
+/*
+ * Újrahasznosítható képpufferek (RGB32) méretosztályonként, az összes csempének közösen.
+ * - acquire() a szabad listából ad puffert (hit), ha nincs, újat foglal (miss).
+ * - A visszaadott QImage a puffert nem birtokolja: amikor az utolsó másolata is megszűnik
+ *   (bármely szálon), a puffer visszakerül a készletbe – nincs külön release() hívás.
+ * - Csempénként így 2–3 puffer kering (worker → postaláda → kirajzolt kép): a
+ *   konverter és a festés közti dupla/tripla pufferelés magától adódik.
+ * - A szabad pufferek összmérete korlátos; a felesleg (pl. átméretezés után) felszabadul.
+ */
+class FramePool
+{
+public:
+    static FramePool &instance();
+
+    // RGB32 kép a készletből; a sorok 64 bájtra igazítva (SIMD-barát)
+    QImage acquire(const QSize &size);
+
+    // minden szabad puffer felszabadítása (a használatban lévők később jönnek vissza)
+    void trim();
+
+    // szabad pufferek felső korlátja bájtban (alapból 256 MB)
+    void setMaxIdleBytes(qint64 bytes);
+
+    // számlálók (bármely szálról olvashatók)
+    quint64 hits() const { return m_hits.load(); }
+    quint64 misses() const { return m_misses.load(); }
+    qint64 idleBytes() const;
+    qint64 liveBytes() const { return m_liveBytes.load(); } // jelenleg képekben használt
+
+private:
+    FramePool() = default;
+    Q_DISABLE_COPY(FramePool)
+
+    struct Buffer
+    {
+        uchar *data = nullptr;
+        qsizetype bytes = 0; // méretosztály
+    };
+
+    static qsizetype sizeClass(qsizetype bytes);
+    static void releaseCallback(void *info);
+    void release(const Buffer &b);
+    void freeExcessLocked(); // m_mutex alatt
+
+    mutable QMutex m_mutex;
+    QHash<qsizetype, QList<uchar *>> m_free; // méretosztály → szabad pufferek (LIFO: meleg cache)
+    QList<qsizetype> m_freeOrder;            // felszabadítási sorrend: a legrégebben visszaadott megy előbb
+    qint64 m_idleBytes{0};
+    qint64 m_maxIdleBytes{256ll * 1024 * 1024};
+
+    std::atomic<quint64> m_hits{0};
+    std::atomic<quint64> m_misses{0};
+    std::atomic<qint64> m_liveBytes{0};
+};
@@ -0,0 +1,356 @@
+#include "libavsource.h"
+
+#include <QThread>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QtMultimedia/QVideoFrameFormat>
+#include <QDebug>
+#include <cstring>
+#include <mutex>
+
+extern "C"
+{
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/opt.h>
+#include <libswscale/swscale.h>
+}
+
+namespace
+{
+    QString avError(int err)
+    {
+        char buf[AV_ERROR_MAX_STRING_SIZE] = {};
+        av_strerror(err, buf, sizeof(buf));
+        return QString::fromUtf8(buf);
+    }
+
+    bool isCodecOption(const QString &key)
+    {
+        static const QStringList keys = {"skip_frame", "threads", "flags", "flags2", "lowres", "skip_loop_filter"};
+        return keys.contains(key);
+    }
+
+    void copyPlane(uchar *dst, int dstStride, const uint8_t *src, int srcStride, int bytes, int rows)
+    {
+        for (int y = 0; y < rows; ++y)
+            std::memcpy(dst + qsizetype(y) * dstStride, src + qsizetype(y) * srcStride, size_t(bytes));
+    }
+}
+
+LibAvSource::LibAvSource(const QString &options, QObject *parent)
+    : StreamSource(LibAv, parent), m_options(options)
+{
+    m_clock.start();
+}
+
+LibAvSource::~LibAvSource()
+{
+    // normál esetben a szál már lefutott (teardown); kilépéskor még várni kell rá
+    m_stop = true;
+    if (m_thread)
+    {
+        m_thread->wait();
+        delete m_thread;
+    }
+    if (m_sws)
+        sws_freeContext(m_sws);
+}
+
+void LibAvSource::open(const QUrl &url)
+{
+    m_url = url;
+    if (m_thread)
+        return; // egy forrás egyszer nyílik meg (újrapróbáláskor a hub újat ad)
+    m_thread = QThread::create([this]
+                               { run(); });
+    m_thread->setObjectName("LibAvSource");
+    m_thread->start();
+}
+
+void LibAvSource::teardown()
+{
+    m_stop = true; // az interrupt callback a blokkoló olvasást is megszakítja
+    if (!m_thread)
+    {
+        deleteLater();
+        return;
+    }
+    // a törlés a szál lefutása után: addig a GUI nem vár rá
+    connect(m_thread, &QThread::finished, this, &QObject::deleteLater);
+    if (m_thread->isFinished())
+        deleteLater();
+}
+
+int LibAvSource::interruptCallback(void *opaque)
+{
+    auto *self = static_cast<LibAvSource *>(opaque);
+    return (self->m_stop.load() || self->m_clock.elapsed() > self->m_ioDeadlineMs.load()) ? 1 : 0;
+}
+
+void LibAvSource::run()
+{
+    static std::once_flag netInit;
+    std::call_once(netInit, []
+                   { avformat_network_init(); });
+
+    // opciók: alacsony késleltetésű alapértékek, a kamera beállítása felülírja
+    AVDictionary *fmtOpts = nullptr;
+    AVDictionary *codecOpts = nullptr;
+    av_dict_set(&fmtOpts, "rtsp_transport", "tcp", 0);
+    av_dict_set(&fmtOpts, "fflags", "nobuffer", 0);
+    av_dict_set(&codecOpts, "flags", "low_delay", 0);
+    const QStringList pairs = m_options.split(QRegularExpression("[;\\n]"), Qt::SkipEmptyParts);
+    for (const QString &pair : pairs)
+    {
+        const QString key = pair.section('=', 0, 0).trimmed();
+        const QString value = pair.section('=', 1).trimmed();
+        if (key.isEmpty())
+            continue;
+        if (key == "io_timeout_ms")
+        {
+            m_ioTimeoutMs = qBound(500, value.toInt(), 120000);
+            continue;
+        }
+        av_dict_set(isCodecOption(key) ? &codecOpts : &fmtOpts, key.toUtf8().constData(), value.toUtf8().constData(), 0);
+    }
+
+    AVFormatContext *fmt = avformat_alloc_context();
+    fmt->interrupt_callback.callback = &LibAvSource::interruptCallback;
+    fmt->interrupt_callback.opaque = this;
+    AVCodecContext *dec = nullptr;
+    AVPacket *pkt = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    bool gotFrame = false;
+
+    auto fail = [&](const QString &what, int err)
+    {
+        if (m_stop)
+            return; // bontás közben nem hiba
+        qDebug() << "[LibAvSource]" << what << m_url.host() << avError(err);
+        postError(QString("%1: %2").arg(what, avError(err)));
+    };
+
+    postStatus(QMediaPlayer::LoadingMedia);
+    m_ioDeadlineMs = m_clock.elapsed() + m_ioTimeoutMs;
+    int err = avformat_open_input(&fmt, m_url.toEncoded().constData(), nullptr, &fmtOpts);
+    if (err < 0)
+    {
+        fmt = nullptr; // hibánál az avformat_open_input felszabadítja
+        fail("open", err);
+        postStatus(QMediaPlayer::InvalidMedia);
+    }
+    int videoIdx = -1;
+    if (fmt)
+    {
+        m_ioDeadlineMs = m_clock.elapsed() + m_ioTimeoutMs;
+        err = avformat_find_stream_info(fmt, nullptr);
+        const AVCodec *codec = nullptr;
+        if (err >= 0)
+            err = videoIdx = av_find_best_stream(fmt, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+        if (err >= 0)
+        {
+            dec = avcodec_alloc_context3(codec);
+            err = dec ? avcodec_parameters_to_context(dec, fmt->streams[videoIdx]->codecpar) : AVERROR(ENOMEM);
+            if (err >= 0)
+                err = avcodec_open2(dec, codec, &codecOpts);
+        }
+        if (err < 0)
+        {
+            fail("probe", err);
+            postStatus(QMediaPlayer::InvalidMedia);
+            videoIdx = -1;
+        }
+        else
+        {
+            // hang és egyéb streamek: a demuxer el se küldje őket
+            for (unsigned i = 0; i < fmt->nb_streams; ++i)
+                if (int(i) != videoIdx)
+                    fmt->streams[i]->discard = AVDISCARD_ALL;
+            postStatus(QMediaPlayer::LoadedMedia);
+        }
+    }
+    av_dict_free(&fmtOpts);
+    av_dict_free(&codecOpts);
+
+    const double timeBase = (videoIdx >= 0) ? av_q2d(fmt->streams[videoIdx]->time_base) : 0.0;
+    // csak kulcskép (minőségi szint): a dekóder a többit ki se bontja; visszaváltáskor a következő
+    // kulcsképig a köztes képeket eldobjuk, hogy ne hiányzó referenciákra épüljenek
+    const AVDiscard configuredSkip = dec ? dec->skip_frame : AVDISCARD_DEFAULT;
+    bool keyframeOnly = false;
+    bool resumeAtKey = false;
+    while (videoIdx >= 0 && !m_stop)
+    {
+        m_ioDeadlineMs = m_clock.elapsed() + m_ioTimeoutMs; // ennyi ideig jöhet semmi
+        err = av_read_frame(fmt, pkt);
+        if (err < 0)
+        {
+            if (m_stop)
+                break;
+            if (err == AVERROR_EOF)
+                postStatus(QMediaPlayer::EndOfMedia);
+            else
+                fail("read", err);
+            break;
+        }
+        if (pkt->stream_index == videoIdx && keyframeOnly != m_keyframeOnly.load())
+        {
+            keyframeOnly = m_keyframeOnly.load();
+            dec->skip_frame = keyframeOnly ? AVDISCARD_NONKEY : configuredSkip;
+            resumeAtKey = !keyframeOnly;
+            qDebug() << "[LibAvSource] keyframe only =" << keyframeOnly << m_url.host();
+        }
+        if (resumeAtKey && pkt->stream_index == videoIdx && (pkt->flags & AV_PKT_FLAG_KEY))
+            resumeAtKey = false;
+        if (pkt->stream_index == videoIdx && !resumeAtKey && avcodec_send_packet(dec, pkt) >= 0)
+        {
+            while (!m_stop && avcodec_receive_frame(dec, frame) >= 0)
+            {
+                const QVideoFrame vf = toVideoFrame(frame, timeBase);
+                av_frame_unref(frame);
+                if (!vf.isValid())
+                    continue;
+                if (!gotFrame)
+                {
+                    gotFrame = true;
+                    postStatus(QMediaPlayer::BufferedMedia);
+                }
+                postFrame(vf);
+            }
+        }
+        av_packet_unref(pkt);
+    }
+
+    av_frame_free(&frame);
+    av_packet_free(&pkt);
+    avcodec_free_context(&dec);
+    if (fmt)
+        avformat_close_input(&fmt);
+    if (!m_stop)
+        postStopped(); // magától állt le: a csempe újrapróbál
+    qDebug() << "[LibAvSource] thread finished" << m_url.host();
+}
+
+QVideoFrame LibAvSource::toVideoFrame(const AVFrame *f, double timeBase)
+{
+    // a gyors konverziós út YUV420P / NV12 síkokat vár: ezek közvetlenül másolódnak, a többi swscale-lel
+    const AVPixelFormat srcFmt = AVPixelFormat(f->format);
+    const bool direct = srcFmt == AV_PIX_FMT_YUV420P || srcFmt == AV_PIX_FMT_YUVJ420P || srcFmt == AV_PIX_FMT_NV12;
+    const QVideoFrameFormat::PixelFormat pf =
+        (srcFmt == AV_PIX_FMT_NV12) ? QVideoFrameFormat::Format_NV12 : QVideoFrameFormat::Format_YUV420P;
+
+    QVideoFrameFormat format(QSize(f->width, f->height), pf);
+    const bool full = srcFmt == AV_PIX_FMT_YUVJ420P || srcFmt == AV_PIX_FMT_YUVJ422P || srcFmt == AV_PIX_FMT_YUVJ444P
+                      || f->color_range == AVCOL_RANGE_JPEG;
+    format.setColorRange(full ? QVideoFrameFormat::ColorRange_Full : QVideoFrameFormat::ColorRange_Video);
+    if (f->colorspace == AVCOL_SPC_BT709)
+        format.setColorSpace(QVideoFrameFormat::ColorSpace_BT709);
+    else if (f->colorspace == AVCOL_SPC_BT470BG || f->colorspace == AVCOL_SPC_SMPTE170M)
+        format.setColorSpace(QVideoFrameFormat::ColorSpace_BT601);
+
+    QVideoFrame out(format);
+    if (!out.map(QVideoFrame::WriteOnly))
+        return QVideoFrame();
+
+    const int w = f->width;
+    const int h = f->height;
+    const int cw = (w + 1) / 2;
+    const int ch = (h + 1) / 2;
+    if (direct)
+    {
+        copyPlane(out.bits(0), out.bytesPerLine(0), f->data[0], f->linesize[0], w, h);
+        if (pf == QVideoFrameFormat::Format_NV12)
+        {
+            copyPlane(out.bits(1), out.bytesPerLine(1), f->data[1], f->linesize[1], cw * 2, ch);
+        }
+        else
+        {
+            copyPlane(out.bits(1), out.bytesPerLine(1), f->data[1], f->linesize[1], cw, ch);
+            copyPlane(out.bits(2), out.bytesPerLine(2), f->data[2], f->linesize[2], cw, ch);
+        }
+    }
+    else
+    {
+        m_sws = sws_getCachedContext(m_sws, w, h, srcFmt, w, h, AV_PIX_FMT_YUV420P, SWS_FAST_BILINEAR,
+                                     nullptr, nullptr, nullptr);
+        if (m_sws)
+        {
+            // a kimenet tartománya a forrásé marad, hogy a fenti címke igaz legyen: alapból a swscale
+            // a J-formátumokat korlátozottra szűkítené, a JPEG-tartományú nem-J formátumot pedig nem jelölné
+            const int range = full ? 1 : 0;
+            const int *coefs = sws_getCoefficients(SWS_CS_DEFAULT);
+            sws_setColorspaceDetails(m_sws, coefs, range, coefs, range, 0, 1 << 16, 1 << 16);
+        }
+        uint8_t *dst[4] = {out.bits(0), out.bits(1), out.bits(2), nullptr};
+        int dstStride[4] = {out.bytesPerLine(0), out.bytesPerLine(1), out.bytesPerLine(2), 0};
+        if (!m_sws || sws_scale(m_sws, f->data, f->linesize, 0, h, dst, dstStride) <= 0)
+        {
+            out.unmap();
+            return QVideoFrame();
+        }
+    }
+    out.unmap();
+
+    // időbélyeg µs-ban: a csempe FPS-szabályzója ebből dolgozik
+    const int64_t pts = (f->best_effort_timestamp != AV_NOPTS_VALUE) ? f->best_effort_timestamp : f->pts;
+    if (pts != AV_NOPTS_VALUE && timeBase > 0.0)
+        out.setStartTime(qint64(pts * timeBase * 1e6));
+    return out;
+}
+
+void LibAvSource::postFrame(const QVideoFrame &frame)
+{
+    bool notify = false;
+    {
+        QMutexLocker lock(&m_mailboxMutex);
+        m_latest = frame; // a GUI által még át nem vett képet felülírjuk: nincs sorban álló késés
+        if (!m_posted)
+        {
+            m_posted = true;
+            notify = true;
+        }
+    }
+    if (notify)
+        QMetaObject::invokeMethod(this, [this]
+                                  { deliverFrame(); }, Qt::QueuedConnection);
+}
+
+void LibAvSource::deliverFrame()
+{
+    QVideoFrame frame;
+    {
+        QMutexLocker lock(&m_mailboxMutex);
+        frame = m_latest;
+        m_latest = QVideoFrame();
+        m_posted = false;
+    }
+    if (frame.isValid())
+        emit frameArrived(frame);
+}
+
+void LibAvSource::postStatus(QMediaPlayer::MediaStatus st)
+{
+    QMetaObject::invokeMethod(this, [this, st]
+                              {
+        // a saját hibaállapot a továbbított jel ELŐTT (mint a QMediaPlayer-es forrásnál)
+        if (st == QMediaPlayer::InvalidMedia || st == QMediaPlayer::EndOfMedia)
+            m_failed = true;
+        emit mediaStatusChanged(st); }, Qt::QueuedConnection);
+}
+
+void LibAvSource::postError(const QString &msg)
+{
+    QMetaObject::invokeMethod(this, [this, msg]
+                              {
+        m_failed = true;
+        emit errorOccurred(QMediaPlayer::ResourceError, msg); }, Qt::QueuedConnection);
+}
+
+void LibAvSource::postStopped()
+{
+    QMetaObject::invokeMethod(this, [this]
+                              {
+        m_failed = true;
+        emit playbackStateChanged(QMediaPlayer::StoppedState); }, Qt::QueuedConnection);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "streamsource.h"
+
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QtMultimedia/QVideoFrame>
+#include <atomic>
+
+class QThread;
+struct AVFrame;
+struct SwsContext;
+
+/*
+ * Közvetlen libavformat/libavcodec lejátszás saját szálon (CAMERAWALL_HAVE_LIBAV fordításnál).
+ * A QMediaPlayer-rel szemben az FFmpeg-opciók elérhetők, kameránként „kulcs=érték;…” alakban, pl.
+ *   rtsp_transport=tcp;fflags=nobuffer;probesize=32768;analyzeduration=0;skip_frame=nokey;threads=2
+ * A dekóder opciói (skip_frame, threads, flags, flags2, lowres) az avcodec_open2-höz, a többi az
+ * avformat_open_input-hoz megy. A frame-ek QVideoFrame-ként (YUV420P / NV12) ugyanazon az úton
+ * jutnak a csempéhez, mint a QMediaPlayer-éi; a GUI felé csak a legutolsó vár (postaláda).
+ */
+class LibAvSource final : public StreamSource
+{
+public:
+    explicit LibAvSource(const QString &options, QObject *parent = nullptr);
+    ~LibAvSource() override;
+
+    void open(const QUrl &url) override; // a szál indítása
+    void setKeyframeOnly(bool on) override { m_keyframeOnly = on; } // a következő csomagtól
+    bool canSkipNonKeyframes() const override { return true; }
+
+protected:
+    void teardown() override; // leállítás; a törlés a szál lefutása után
+
+private:
+    void run(); // dolgozó szál: megnyitás, demux, dekódolás
+    static int interruptCallback(void *opaque);
+    QVideoFrame toVideoFrame(const AVFrame *frame, double timeBase);
+
+    // a dolgozó szálról: postaládába tesz, és csak akkor jelez, ha az előzőt már átvették
+    void postFrame(const QVideoFrame &frame);
+    void deliverFrame(); // GUI szál
+    void postStatus(QMediaPlayer::MediaStatus st);
+    void postError(const QString &msg);
+    void postStopped();
+
+    QString m_options;
+    QThread *m_thread{};
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_keyframeOnly{false}; // skip_frame=nokey
+    std::atomic<qint64> m_ioDeadlineMs{0}; // a blokkoló I/O eddig tarthat (m_clock szerint)
+    QElapsedTimer m_clock;
+    int m_ioTimeoutMs{10000};
+
+    QMutex m_mailboxMutex;
+    QVideoFrame m_latest;
+    bool m_posted{false};
+
+    SwsContext *m_sws{}; // csak nem közvetlenül átvehető pixelformátumnál (dolgozó szál)
+};
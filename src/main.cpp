@@ -13,6 +13,9 @@
 #include <QTextStream>
 #include <QDateTime>
 
+#include <memory>
+#include <vector>
+
 static QFile gLogFile;
 static void fileLogHandler(QtMsgType, const QMessageLogContext &, const QString &msg)
 {
@@ -58,13 +61,14 @@ int main(int argc, char **argv)
     const QString iniPath = QCoreApplication::applicationDirPath() + "/CameraWall.ini";
     QSettings settings(iniPath, QSettings::IniFormat);
 
-    // --- Command line: --screen=<index-or-name>, --debug ---
+    // --- Command line: --screen=<index-or-name>[,<index-or-name>…], --debug ---
     QCommandLineParser parser;
     parser.setApplicationDescription("CameraWall");
     parser.addHelpOption();
 
     QCommandLineOption optScreen(QStringList() << "screen",
-                                 "Screen index (0..N-1) or name substring.",
+                                 "Screen index (0..N-1) or name substring. Repeat or separate with commas "
+                                 "to open one wall per screen in a single process.",
                                  "index-or-name");
     parser.addOption(optScreen);
 
@@ -81,9 +85,9 @@ int main(int argc, char **argv)
                  << (QCoreApplication::applicationDirPath() + "/CameraWall.log");
     }
 
-    // --- Cél képernyő meghatározása ---
+    // --- Cél képernyő(k) meghatározása ---
     const auto screens = QGuiApplication::screens();
-    QScreen *targetScreen = nullptr;
+    QList<QScreen *> targetScreens; // falanként egy; üres = alapértelmezett képernyő, egy fal
 
     auto findScreenByName = [&](const QString &name) -> QScreen *
     {
@@ -92,81 +96,116 @@ int main(int argc, char **argv)
                 return s;
         return nullptr;
     };
+    auto resolveScreen = [&](const QString &value) -> QScreen *
+    {
+        bool ok = false;
+        const int idx = value.toInt(&ok);
+        if (ok)
+            return (idx >= 0 && idx < screens.size()) ? screens.at(idx) : nullptr;
+        return findScreenByName(value);
+    };
 
     if (parser.isSet(optScreen))
     {
         // 1) Parancssor elsőbbséget élvez -> resolve + mentés ini-be
-        const QString value = parser.value(optScreen).trimmed();
-        bool ok = false;
-        int idx = value.toInt(&ok);
-        if (ok)
+        QStringList values;
+        for (const QString &v : parser.values(optScreen))
+            values << v.split(',', Qt::SkipEmptyParts);
+        QStringList names;
+        for (const QString &raw : std::as_const(values))
         {
-            if (idx >= 0 && idx < screens.size())
-                targetScreen = screens.at(idx);
-        }
-        else
-        {
-            targetScreen = findScreenByName(value);
+            const QString value = raw.trimmed();
+            QScreen *scr = resolveScreen(value);
+            if (!scr)
+            {
+                qDebug() << "[main] --screen value could not be resolved:" << value;
+                continue;
+            }
+            if (targetScreens.contains(scr))
+                continue; // egy képernyőn egy fal
+            targetScreens << scr;
+            names << scr->name();
         }
 
-        if (targetScreen)
+        if (!targetScreens.isEmpty())
         {
-            // Mentsük a név + index párost
-            settings.setValue("ui/screenName", targetScreen->name());
-            settings.setValue("ui/screenIndex", screens.indexOf(targetScreen));
+            // Mentsük a név + index párost (az első falé), és a teljes listát
+            settings.setValue("ui/screenName", targetScreens.first()->name());
+            settings.setValue("ui/screenIndex", screens.indexOf(targetScreens.first()));
+            settings.setValue("ui/screens", names);
             settings.sync();
-            qDebug() << "[main] --screen set -> will use screen:"
-                     << targetScreen->name()
-                     << "index:" << settings.value("ui/screenIndex").toInt();
-        }
-        else
-        {
-            qDebug() << "[main] --screen value could not be resolved:" << value;
+            qDebug() << "[main] --screen set -> will use screens:" << names;
         }
     }
     else
     {
-        // 2) Nincs parancssor -> olvasd az ini-ből
-        const QString savedName = settings.value("ui/screenName").toString();
-        const int savedIdx = settings.value("ui/screenIndex", -1).toInt();
-
-        if (!savedName.isEmpty())
+        // 2) Nincs parancssor -> olvasd az ini-ből (ui/screens: több fal; régi: ui/screenName/Index)
+        const QStringList savedList = settings.value("ui/screens").toStringList();
+        for (const QString &name : savedList)
         {
-            targetScreen = findScreenByName(savedName);
-            qDebug() << "[main] ini ui/screenName =" << savedName
-                     << " -> resolved:" << (targetScreen ? targetScreen->name() : QString("<none>"));
+            QScreen *scr = findScreenByName(name);
+            qDebug() << "[main] ini ui/screens entry" << name
+                     << " -> resolved:" << (scr ? scr->name() : QString("<none>"));
+            if (scr && !targetScreens.contains(scr))
+                targetScreens << scr;
         }
 
-        if (!targetScreen && savedIdx >= 0 && savedIdx < screens.size())
+        if (targetScreens.isEmpty())
         {
-            targetScreen = screens.at(savedIdx);
-            qDebug() << "[main] ini ui/screenIndex =" << savedIdx
-                     << " -> fallback resolved:" << (targetScreen ? targetScreen->name() : QString("<none>"));
+            const QString savedName = settings.value("ui/screenName").toString();
+            const int savedIdx = settings.value("ui/screenIndex", -1).toInt();
+            QScreen *targetScreen = nullptr;
+
+            if (!savedName.isEmpty())
+            {
+                targetScreen = findScreenByName(savedName);
+                qDebug() << "[main] ini ui/screenName =" << savedName
+                         << " -> resolved:" << (targetScreen ? targetScreen->name() : QString("<none>"));
+            }
+
+            if (!targetScreen && savedIdx >= 0 && savedIdx < screens.size())
+            {
+                targetScreen = screens.at(savedIdx);
+                qDebug() << "[main] ini ui/screenIndex =" << savedIdx
+                         << " -> fallback resolved:" << (targetScreen ? targetScreen->name() : QString("<none>"));
+            }
+            if (targetScreen)
+                targetScreens << targetScreen;
         }
     }
 
-    // --- Ablak létrehozás + képernyőre helyezés ---
-    CameraWall w;
-
-    if (targetScreen)
+    // --- Ablak(ok) létrehozása + képernyőre helyezés ---
+    // minden fal saját elrendezéssel/lapozással, de a dekódolás közös (StreamHub):
+    // ugyanaz a kamera több képernyőn is csak egyszer dekódolódik
+    const int wallCount = qMax(1, int(targetScreens.size()));
+    CameraWall::applyGlobalSettings(); // közös ütemezők: egyszer, nem falanként
+    std::vector<std::unique_ptr<CameraWall>> walls;
+    for (int i = 0; i < wallCount; ++i)
     {
-        if (!w.windowHandle())
-            w.createWinId(); // biztosítja a native ablakot
+        auto w = std::make_unique<CameraWall>(i);
+        QScreen *targetScreen = targetScreens.value(i, nullptr);
 
-        if (w.windowHandle())
-            w.windowHandle()->setScreen(targetScreen);
+        if (targetScreen)
+        {
+            if (!w->windowHandle())
+                w->createWinId(); // biztosítja a native ablakot
 
-        // ha a konstruktor még nem tette full screenre, ez akkor is jó kezdő pozíció
-        w.setGeometry(targetScreen->availableGeometry());
+            if (w->windowHandle())
+                w->windowHandle()->setScreen(targetScreen);
 
-        qDebug() << "[main] Using screen:" << targetScreen->name()
-                 << "geometry:" << targetScreen->availableGeometry();
-    }
-    else
-    {
-        qDebug() << "[main] No target screen selected (cmd/ini). Using default screen.";
-    }
+            // ha a konstruktor még nem tette full screenre, ez akkor is jó kezdő pozíció
+            w->setGeometry(targetScreen->availableGeometry());
 
-    w.show(); // a konstruktora már full screenre teheti, ez ártalmatlan
+            qDebug() << "[main] Wall" << i << "using screen:" << targetScreen->name()
+                     << "geometry:" << targetScreen->availableGeometry();
+        }
+        else
+        {
+            qDebug() << "[main] No target screen selected (cmd/ini). Using default screen.";
+        }
+
+        w->show(); // a konstruktora már full screenre teheti, ez ártalmatlan
+        walls.push_back(std::move(w));
+    }
     return app.exec();
 }
@@ -52,50 +52,185 @@ QByteArray OnvifClient::envelope(const QString &bodyXml, const QString &user, co
     return env.toUtf8();
 }
 
-bool OnvifClient::postSync(const QNetworkRequest &nr, const QByteArray &payload, QByteArray &out, QString *err)
-{
-    QNetworkAccessManager nam;
-    QNetworkReply *rp = nam.post(nr, payload);
-    QEventLoop loop;
-    QObject::connect(rp, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    QTimer timer;
-    timer.setSingleShot(true);
-    QObject::connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
-    timer.start(8000);
-    loop.exec();
-    if (rp->isRunning())
+OnvifClient &OnvifClient::instance()
+{
+    // szándékosan nem szabadul fel (a NAM a program végéig él)
+    static OnvifClient *inst = new OnvifClient;
+    return *inst;
+}
+
+OnvifClient::OnvifClient()
+{
+    connect(&m_nam, &QNetworkAccessManager::finished, this, &OnvifClient::finish);
+}
+
+void OnvifClient::setMaxInFlight(int n)
+{
+    m_maxInFlight = qBound(1, n, 64);
+    pump();
+}
+
+OnvifClient::RequestId OnvifClient::post(const QUrl &url, const char *soapAction, const QByteArray &payload,
+                                         QObject *context, Handler handler)
+{
+    Request r;
+    r.id = m_nextId++;
+    r.nr = QNetworkRequest(url);
+    addCommonHeaders(r.nr, soapAction);
+    r.payload = payload;
+    r.context = context;
+    r.hasContext = (context != nullptr);
+    r.handler = std::move(handler);
+    if (context)
     {
-        rp->abort();
-        rp->deleteLater();
-        if (err)
-            *err = "Timeout during ONVIF request.";
-        return false;
+        // a kérő megszűnése: sorból kivesszük, futó kérést megszakítunk
+        const RequestId id = r.id;
+        r.contextGone = connect(context, &QObject::destroyed, this, [this, id]
+                                { cancel(id); });
     }
-    if (rp->error() != QNetworkReply::NoError)
+    m_queue << r;
+    // a hívó visszatérése után indul: a callback sosem fut szinkron a hívásból
+    QMetaObject::invokeMethod(this, &OnvifClient::pump, Qt::QueuedConnection);
+    return r.id;
+}
+
+void OnvifClient::pump()
+{
+    while (m_running.size() < m_maxInFlight && !m_queue.isEmpty())
+    {
+        Request r = m_queue.takeFirst();
+        if (r.hasContext && !r.context)
+        {
+            disconnect(r.contextGone);
+            continue; // a kérő közben megszűnt
+        }
+        QNetworkReply *rp = m_nam.post(r.nr, r.payload);
+        m_running.insert(rp, r);
+    }
+}
+
+void OnvifClient::cancel(RequestId id)
+{
+    for (int i = 0; i < m_queue.size(); ++i)
     {
-        if (err)
-            *err = rp->errorString();
-        rp->deleteLater();
-        return false;
+        if (m_queue[i].id == id)
+        {
+            disconnect(m_queue[i].contextGone);
+            m_queue.removeAt(i);
+            return;
+        }
+    }
+    for (auto it = m_running.begin(); it != m_running.end(); ++it)
+    {
+        if (it.value().id == id)
+        {
+            QNetworkReply *rp = it.key();
+            disconnect(it.value().contextGone);
+            m_running.erase(it); // a finished() már nem talál gazdát
+            rp->abort();
+            return;
+        }
     }
-    out = rp->readAll();
+}
+
+void OnvifClient::finish(QNetworkReply *rp)
+{
     rp->deleteLater();
-    return true;
+    const auto it = m_running.find(rp);
+    if (it == m_running.end())
+    {
+        pump(); // visszavont kérés
+        return;
+    }
+    const Request r = it.value();
+    m_running.erase(it);
+    disconnect(r.contextGone); // a kérő hosszú életű lehet (pl. a fal): ne gyűljenek a kötések
+    pump(); // a felszabadult helyre jöhet a következő
+
+    if (r.hasContext && !r.context)
+        return;
+    if (rp->error() != QNetworkReply::NoError)
+    {
+        const QString err = (rp->error() == QNetworkReply::OperationCanceledError)
+                                ? QStringLiteral("Timeout during ONVIF request.")
+                                : rp->errorString();
+        r.handler(false, QByteArray(), err);
+        return;
+    }
+    r.handler(true, rp->readAll(), QString());
 }
 
-bool OnvifClient::getCapabilities(const QUrl &deviceXAddr, const QString &user, const QString &pass,
-                                  QUrl &mediaXAddr, QString *err)
+OnvifClient::RequestId OnvifClient::getCapabilities(const QUrl &deviceXAddr, const QString &user, const QString &pass,
+                                                    QObject *context, CapabilitiesCallback done)
 {
     const QString body =
         R"(<tds:GetCapabilities xmlns:tds="http://www.onvif.org/ver10/device/wsdl"><tds:Category>All</tds:Category></tds:GetCapabilities>)";
-    QByteArray req = envelope(body, user, pass);
-    QNetworkRequest nr(deviceXAddr);
-    addCommonHeaders(nr, "http://www.onvif.org/ver10/device/wsdl/GetCapabilities");
-    QByteArray resp;
-    if (!postSync(nr, req, resp, err))
-        return false;
-
-    QXmlStreamReader xr(resp);
+    return post(deviceXAddr, "http://www.onvif.org/ver10/device/wsdl/GetCapabilities", envelope(body, user, pass),
+                context, [done](bool ok, const QByteArray &resp, const QString &err)
+                {
+        if (!ok)
+        {
+            done(false, QUrl(), err);
+            return;
+        }
+        QUrl media;
+        if (parseMediaXAddr(resp, media))
+            done(true, media, QString());
+        else
+            done(false, QUrl(), QStringLiteral("I couldn't find Media XAddr in the GetCapabilities response.")); });
+}
+
+OnvifClient::RequestId OnvifClient::getProfiles(const QUrl &mediaXAddr, const QString &user, const QString &pass,
+                                                QObject *context, ProfilesCallback done)
+{
+    const QString body = R"(<trt:GetProfiles xmlns:trt="http://www.onvif.org/ver10/media/wsdl"/>)";
+    return post(mediaXAddr, "http://www.onvif.org/ver10/media/wsdl/GetProfiles", envelope(body, user, pass),
+                context, [done](bool ok, const QByteArray &resp, const QString &err)
+                {
+        QList<OnvifProfile> out;
+        if (!ok)
+        {
+            done(false, out, err);
+            return;
+        }
+        parseProfiles(resp, out);
+        if (out.isEmpty())
+            done(false, out, QStringLiteral("I did not receive any ONVIF profiles back."));
+        else
+            done(true, out, QString()); });
+}
+
+OnvifClient::RequestId OnvifClient::getStreamUri(const QUrl &mediaXAddr, const QString &user, const QString &pass,
+                                                 const QString &profileToken, QObject *context, StreamUriCallback done)
+{
+    const QString body = QString::fromUtf8(R"(
+<trt:GetStreamUri xmlns:trt="http://www.onvif.org/ver10/media/wsdl" xmlns:tt="http://www.onvif.org/ver10/schema">
+  <trt:StreamSetup>
+    <tt:Stream>RTP-Unicast</tt:Stream>
+    <tt:Transport><tt:Protocol>RTSP</tt:Protocol></tt:Transport>
+  </trt:StreamSetup>
+  <trt:ProfileToken>%1</trt:ProfileToken>
+</trt:GetStreamUri>)")
+                             .arg(profileToken.toHtmlEscaped());
+
+    return post(mediaXAddr, "http://www.onvif.org/ver10/media/wsdl/GetStreamUri", envelope(body, user, pass),
+                context, [done](bool ok, const QByteArray &resp, const QString &err)
+                {
+        if (!ok)
+        {
+            done(false, QString(), err);
+            return;
+        }
+        QString uri;
+        if (parseStreamUri(resp, uri))
+            done(true, uri, QString());
+        else
+            done(false, QString(), QStringLiteral("I couldn't find a Uri field in the GetStreamUri response.")); });
+}
+
+bool OnvifClient::parseMediaXAddr(const QByteArray &xml, QUrl &mediaXAddr)
+{
+    QXmlStreamReader xr(xml);
     while (!xr.atEnd())
     {
         xr.readNext();
@@ -113,52 +248,12 @@ bool OnvifClient::getCapabilities(const QUrl &deviceXAddr, const QString &user,
             }
         }
     }
-    if (err)
-        *err = "I couldn't find Media XAddr in the GetCapabilities response.";
     return false;
 }
 
-bool OnvifClient::getProfiles(const QUrl &mediaXAddr, const QString &user, const QString &pass,
-                              QList<OnvifProfile> &out, QString *err)
+bool OnvifClient::parseStreamUri(const QByteArray &xml, QString &rtspUri)
 {
-    const QString body = R"(<trt:GetProfiles xmlns:trt="http://www.onvif.org/ver10/media/wsdl"/>)";
-    QByteArray req = envelope(body, user, pass);
-    QNetworkRequest nr(mediaXAddr);
-    addCommonHeaders(nr, "http://www.onvif.org/ver10/media/wsdl/GetProfiles");
-    QByteArray resp;
-    if (!postSync(nr, req, resp, err))
-        return false;
-    parseProfiles(resp, out);
-    if (out.isEmpty())
-    {
-        if (err)
-            *err = "I did not receive any ONVIF profiles back.";
-        return false;
-    }
-    return true;
-}
-
-bool OnvifClient::getStreamUri(const QUrl &mediaXAddr, const QString &user, const QString &pass,
-                               const QString &profileToken, QString &rtspUri, QString *err)
-{
-    const QString body = QString::fromUtf8(R"(
-<trt:GetStreamUri xmlns:trt="http://www.onvif.org/ver10/media/wsdl" xmlns:tt="http://www.onvif.org/ver10/schema">
-  <trt:StreamSetup>
-    <tt:Stream>RTP-Unicast</tt:Stream>
-    <tt:Transport><tt:Protocol>RTSP</tt:Protocol></tt:Transport>
-  </trt:StreamSetup>
-  <trt:ProfileToken>%1</trt:ProfileToken>
-</trt:GetStreamUri>)")
-                             .arg(profileToken.toHtmlEscaped());
-
-    QByteArray req = envelope(body, user, pass);
-    QNetworkRequest nr(mediaXAddr);
-    addCommonHeaders(nr, "http://www.onvif.org/ver10/media/wsdl/GetStreamUri");
-    QByteArray resp;
-    if (!postSync(nr, req, resp, err))
-        return false;
-
-    QXmlStreamReader xr(resp);
+    QXmlStreamReader xr(xml);
     while (!xr.atEnd())
     {
         xr.readNext();
@@ -168,8 +263,6 @@ bool OnvifClient::getStreamUri(const QUrl &mediaXAddr, const QString &user, cons
             return !rtspUri.isEmpty();
         }
     }
-    if (err)
-        *err = "I couldn't find a Uri field in the GetStreamUri response.";
     return false;
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 #include <QtCore>
 #include <QtNetwork>
+#include <functional>
 
 struct OnvifProfile
 {
@@ -10,25 +11,74 @@ struct OnvifProfile
     QSize resolution;
 };
 
-class OnvifClient
+/*
+ * Aszinkron ONVIF SOAP kliens.
+ * - Egyetlen közös QNetworkAccessManager: a HTTP keep-alive kapcsolatok eszközönként újrahasznosulnak.
+ * - Egyszerre legfeljebb maxInFlight kérés fut, a többi sorban vár (sok kamera indulásakor is).
+ * - Az eredmény callback-ben jön a GUI szálon; a context objektum törlésekor a kérés elmarad/megszakad,
+ *   cancel()-lel egyenként is visszavonható. Semmi sem blokkol és nincs beágyazott eseményciklus.
+ */
+class OnvifClient : public QObject
 {
+    Q_OBJECT
 public:
-    OnvifClient() = default;
+    using RequestId = quint64;
+    using CapabilitiesCallback = std::function<void(bool ok, const QUrl &mediaXAddr, const QString &err)>;
+    using ProfilesCallback = std::function<void(bool ok, const QList<OnvifProfile> &profiles, const QString &err)>;
+    using StreamUriCallback = std::function<void(bool ok, const QString &rtspUri, const QString &err)>;
 
-    bool getCapabilities(const QUrl &deviceXAddr, const QString &user, const QString &pass,
-                         QUrl &mediaXAddr, QString *err = nullptr);
+    static OnvifClient &instance();
 
-    bool getProfiles(const QUrl &mediaXAddr, const QString &user, const QString &pass,
-                     QList<OnvifProfile> &out, QString *err = nullptr);
+    RequestId getCapabilities(const QUrl &deviceXAddr, const QString &user, const QString &pass,
+                              QObject *context, CapabilitiesCallback done);
 
-    bool getStreamUri(const QUrl &mediaXAddr, const QString &user, const QString &pass,
-                      const QString &profileToken, QString &rtspUri, QString *err = nullptr);
+    RequestId getProfiles(const QUrl &mediaXAddr, const QString &user, const QString &pass,
+                          QObject *context, ProfilesCallback done);
+
+    RequestId getStreamUri(const QUrl &mediaXAddr, const QString &user, const QString &pass,
+                           const QString &profileToken, QObject *context, StreamUriCallback done);
+
+    // a callback már nem hívódik meg (futó kérésnél a reply megszakad)
+    void cancel(RequestId id);
+
+    void setMaxInFlight(int n);
+    int maxInFlight() const { return m_maxInFlight; }
+    int inFlight() const { return int(m_running.size()); }
+    int queued() const { return int(m_queue.size()); }
 
 private:
+    OnvifClient();
+    Q_DISABLE_COPY(OnvifClient)
+
+    // válasz-feldolgozó: (ok, törzs, hibaszöveg) – a hívó típusos callback-jét hívja
+    using Handler = std::function<void(bool ok, const QByteArray &body, const QString &err)>;
+
+    struct Request
+    {
+        RequestId id = 0;
+        QNetworkRequest nr;
+        QByteArray payload;
+        QPointer<QObject> context;
+        bool hasContext = false;
+        QMetaObject::Connection contextGone; // a kérő destroyed() jele; a kérés végén bontjuk
+        Handler handler;
+    };
+
+    RequestId post(const QUrl &url, const char *soapAction, const QByteArray &payload,
+                   QObject *context, Handler handler);
+    void pump();
+    void finish(QNetworkReply *rp);
+
     static void addCommonHeaders(QNetworkRequest &nr, const char *soapAction);
     static QByteArray envelope(const QString &bodyXml, const QString &user, const QString &pass);
-    static bool postSync(const QNetworkRequest &nr, const QByteArray &payload,
-                         QByteArray &out, QString *err);
+    static bool parseMediaXAddr(const QByteArray &xml, QUrl &mediaXAddr);
     static void parseProfiles(const QByteArray &xml, QList<OnvifProfile> &out);
+    static bool parseStreamUri(const QByteArray &xml, QString &rtspUri);
     static QString wssePasswordDigest(const QByteArray &nonce, const QString &created, const QString &password);
+
+    QNetworkAccessManager m_nam;
+    QList<Request> m_queue;
+    QHash<QNetworkReply *, Request> m_running;
+    RequestId m_nextId{1};
+    int m_maxInFlight{8};
 };
@@ -0,0 +1,268 @@
+#include "onvifdiscovery.h"
+
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+#include <QUuid>
+#include <QXmlStreamReader>
+#include <QDebug>
+
+OnvifDiscovery::OnvifDiscovery(QObject *parent)
+    : QObject(parent)
+{
+    m_collect.setSingleShot(true);
+    connect(&m_collect, &QTimer::timeout, this, [this]
+            {
+        m_collecting = false;
+        if (m_socket)
+            m_socket->close();
+        checkFinished(); });
+    m_resend.setSingleShot(true);
+    connect(&m_resend, &QTimer::timeout, this, &OnvifDiscovery::sendProbe);
+}
+
+OnvifDiscovery::~OnvifDiscovery()
+{
+    stop();
+}
+
+void OnvifDiscovery::setProbeTarget(const QHostAddress &addr, quint16 port)
+{
+    m_target = addr;
+    m_targetPort = port;
+}
+
+void OnvifDiscovery::setCredentials(const QString &user, const QString &pass)
+{
+    m_user = user;
+    m_pass = pass;
+}
+
+bool OnvifDiscovery::start(int timeoutMs)
+{
+    stop();
+    m_devices.clear();
+    m_detailQueue.clear();
+
+    if (!m_socket)
+    {
+        m_socket = new QUdpSocket(this);
+        connect(m_socket, &QUdpSocket::readyRead, this, &OnvifDiscovery::readDatagrams);
+    }
+    // saját (véletlen) porton várjuk a unicast ProbeMatch válaszokat
+    if (!m_socket->bind(QHostAddress(QHostAddress::AnyIPv4), 0))
+    {
+        qDebug() << "[OnvifDiscovery] bind failed:" << m_socket->errorString();
+        return false;
+    }
+    m_socket->setSocketOption(QAbstractSocket::MulticastTtlOption, 4);
+
+    m_messageId = "uuid:" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+    m_running = true;
+    m_collecting = true;
+    sendProbe();
+    m_resend.start(qMin(500, timeoutMs / 2)); // UDP: elveszhet, egyszer megismételjük
+    m_collect.start(qMax(200, timeoutMs));
+    qDebug() << "[OnvifDiscovery] probe ->" << m_target.toString() << m_targetPort;
+    return true;
+}
+
+void OnvifDiscovery::stop()
+{
+    m_collect.stop();
+    m_resend.stop();
+    m_collecting = false;
+    if (m_socket)
+        m_socket->close();
+    for (OnvifClient::RequestId id : std::as_const(m_inFlight))
+        OnvifClient::instance().cancel(id);
+    m_inFlight.clear();
+    m_detailQueue.clear();
+    m_running = false;
+}
+
+void OnvifDiscovery::sendProbe()
+{
+    if (!m_socket || !m_collecting)
+        return;
+    m_socket->writeDatagram(probeMessage(m_messageId), m_target, m_targetPort);
+}
+
+QByteArray OnvifDiscovery::probeMessage(const QString &messageId)
+{
+    return QString::fromUtf8(R"(<?xml version="1.0" encoding="UTF-8"?>
+<e:Envelope xmlns:e="http://www.w3.org/2003/05/soap-envelope"
+            xmlns:w="http://schemas.xmlsoap.org/ws/2004/08/addressing"
+            xmlns:d="http://schemas.xmlsoap.org/ws/2005/04/discovery"
+            xmlns:dn="http://www.onvif.org/ver10/network/wsdl">
+  <e:Header>
+    <w:MessageID>%1</w:MessageID>
+    <w:To e:mustUnderstand="true">urn:schemas-xmlsoap-org:ws:2005:04:discovery</w:To>
+    <w:Action e:mustUnderstand="true">http://schemas.xmlsoap.org/ws/2005/04/discovery/Probe</w:Action>
+  </e:Header>
+  <e:Body>
+    <d:Probe><d:Types>dn:NetworkVideoTransmitter</d:Types></d:Probe>
+  </e:Body>
+</e:Envelope>)")
+        .arg(messageId)
+        .toUtf8();
+}
+
+bool OnvifDiscovery::parseProbeMatches(const QByteArray &xml, const QString &messageId, QList<Device> &out)
+{
+    QXmlStreamReader xr(xml);
+    QString relatesTo;
+    Device cur;
+    bool inMatch = false, inEpr = false;
+    while (!xr.atEnd())
+    {
+        xr.readNext();
+        if (xr.isStartElement())
+        {
+            const QStringView name = xr.name();
+            if (name == QLatin1String("RelatesTo"))
+                relatesTo = xr.readElementText().trimmed();
+            else if (name == QLatin1String("ProbeMatch"))
+            {
+                inMatch = true;
+                cur = Device{};
+            }
+            else if (inMatch && name == QLatin1String("EndpointReference"))
+                inEpr = true;
+            else if (inEpr && name == QLatin1String("Address"))
+                cur.endpoint = xr.readElementText().trimmed();
+            else if (inMatch && name == QLatin1String("Scopes"))
+                cur.scopes = xr.readElementText().simplified().split(' ', Qt::SkipEmptyParts);
+            else if (inMatch && name == QLatin1String("XAddrs"))
+            {
+                const QStringList addrs = xr.readElementText().simplified().split(' ', Qt::SkipEmptyParts);
+                for (const QString &a : addrs)
+                {
+                    const QUrl u(a);
+                    if (u.isValid() && u.scheme().startsWith("http"))
+                        cur.xaddrs << u;
+                }
+            }
+        }
+        else if (xr.isEndElement())
+        {
+            const QStringView name = xr.name();
+            if (name == QLatin1String("EndpointReference"))
+                inEpr = false;
+            else if (name == QLatin1String("ProbeMatch") && inMatch)
+            {
+                inMatch = false;
+                if (cur.endpoint.isEmpty() && !cur.xaddrs.isEmpty())
+                    cur.endpoint = cur.xaddrs.first().toString(); // azonosító nélküli (hibás) eszköz
+                if (!cur.endpoint.isEmpty())
+                    out << cur;
+            }
+        }
+    }
+    if (xr.hasError())
+        return false;
+    // más keresés válasza (vagy Hello/Bye) – nem a mienk
+    if (!messageId.isEmpty() && !relatesTo.isEmpty() && relatesTo != messageId)
+        return false;
+
+    for (Device &d : out)
+    {
+        for (const QString &sc : std::as_const(d.scopes))
+        {
+            const QString dec = QUrl::fromPercentEncoding(sc.toUtf8());
+            if (dec.startsWith("onvif://www.onvif.org/name/", Qt::CaseInsensitive))
+                d.name = dec.mid(27);
+            else if (dec.startsWith("onvif://www.onvif.org/hardware/", Qt::CaseInsensitive))
+                d.hardware = dec.mid(31);
+        }
+    }
+    return true;
+}
+
+void OnvifDiscovery::readDatagrams()
+{
+    while (m_socket && m_socket->hasPendingDatagrams())
+    {
+        const QNetworkDatagram dg = m_socket->receiveDatagram();
+        QList<Device> found;
+        if (!parseProbeMatches(dg.data(), m_messageId, found))
+            continue;
+        for (Device &d : found)
+        {
+            if (m_devices.contains(d.endpoint))
+                continue; // ismételt próbára / több interfészről jött ugyanaz
+            if (d.xaddrs.isEmpty())
+            {
+                // XAddrs nélkül: a feladó címéből a szabványos device_service
+                QUrl u;
+                u.setScheme("http");
+                u.setHost(dg.senderAddress().toString());
+                u.setPath("/onvif/device_service");
+                d.xaddrs << u;
+            }
+            m_devices.insert(d.endpoint, d);
+            qDebug() << "[OnvifDiscovery] found" << d.endpoint << d.deviceXAddr() << d.name;
+            emit deviceFound(d);
+            if (m_fetchDetails)
+                m_detailQueue << d.endpoint;
+        }
+    }
+    pumpDetails();
+}
+
+void OnvifDiscovery::pumpDetails()
+{
+    while (m_running && m_inFlight.size() < m_maxConcurrent && !m_detailQueue.isEmpty())
+    {
+        const QString ep = m_detailQueue.takeFirst();
+        const Device d = m_devices.value(ep);
+        m_inFlight.insert(ep, OnvifClient::instance().getCapabilities(
+                                  d.deviceXAddr(), m_user, m_pass, this,
+                                  [this, ep](bool ok, const QUrl &media, const QString &err)
+                                  {
+            auto it = m_devices.find(ep);
+            if (it == m_devices.end())
+                return;
+            if (!ok)
+            {
+                it->error = err;
+                detailsDone(ep);
+                return;
+            }
+            it->mediaXAddr = media;
+            // ugyanazon a helyen folytatjuk: az eszköz a korláton belül marad
+            m_inFlight[ep] = OnvifClient::instance().getProfiles(
+                media, m_user, m_pass, this,
+                [this, ep](bool ok, const QList<OnvifProfile> &profs, const QString &err)
+                {
+                auto it = m_devices.find(ep);
+                if (it == m_devices.end())
+                    return;
+                if (ok)
+                    it->profiles = profs;
+                else
+                    it->error = err;
+                detailsDone(ep); }); }));
+    }
+    checkFinished();
+}
+
+void OnvifDiscovery::detailsDone(const QString &endpoint)
+{
+    m_inFlight.remove(endpoint);
+    auto it = m_devices.find(endpoint);
+    if (it != m_devices.end())
+    {
+        it->detailsDone = true;
+        emit deviceUpdated(*it);
+    }
+    pumpDetails();
+}
+
+void OnvifDiscovery::checkFinished()
+{
+    if (!m_running || m_collecting || !m_inFlight.isEmpty() || !m_detailQueue.isEmpty())
+        return;
+    m_running = false;
+    qDebug() << "[OnvifDiscovery] finished," << m_devices.size() << "device(s)";
+    emit finished();
+}
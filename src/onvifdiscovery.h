@@ -0,0 +1,85 @@
+#pragma once
+#include <QObject>
+#include <QHostAddress>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+#include <QUrl>
+#include "onvifclient.h"
+
+class QUdpSocket;
+
+/*
+ * ONVIF eszközkeresés WS-Discovery-vel (UDP multicast Probe → ProbeMatch), blokkolás nélkül.
+ * - A válaszok párhuzamosan gyűlnek, végpont-azonosító (EndpointReference) szerint egyszer.
+ * - Minden új eszközre GetCapabilities → GetProfiles fut, legfeljebb maxConcurrent eszközre egyszerre.
+ * - Az eredmények folyamatosan jönnek (deviceFound / deviceUpdated), a keresés végén finished().
+ * - A próba célja állítható (alapból 239.255.255.250:3702), így helyi (loopback) válaszolóval is próbálható.
+ */
+class OnvifDiscovery : public QObject
+{
+    Q_OBJECT
+public:
+    struct Device
+    {
+        QString endpoint;      // wsa:EndpointReference/Address (urn:uuid:…) – azonosító
+        QList<QUrl> xaddrs;    // device_service címek
+        QStringList scopes;
+        QString name;          // onvif://www.onvif.org/name/… scope-ból
+        QString hardware;      // onvif://www.onvif.org/hardware/…
+        QUrl mediaXAddr;       // GetCapabilities után
+        QList<OnvifProfile> profiles;
+        QString error;         // a profil-lekérés hibája (ha volt)
+        bool detailsDone = false;
+
+        QUrl deviceXAddr() const { return xaddrs.isEmpty() ? QUrl() : xaddrs.first(); }
+    };
+
+    explicit OnvifDiscovery(QObject *parent = nullptr);
+    ~OnvifDiscovery() override;
+
+    void setProbeTarget(const QHostAddress &addr, quint16 port);
+    void setCredentials(const QString &user, const QString &pass);
+    void setFetchDetails(bool on) { m_fetchDetails = on; }
+    void setMaxConcurrent(int n) { m_maxConcurrent = qBound(1, n, 32); }
+
+    // timeoutMs: ennyi ideig gyűjtjük a ProbeMatch válaszokat
+    bool start(int timeoutMs = 3000);
+    void stop();
+    bool isRunning() const { return m_running; }
+    QList<Device> devices() const { return m_devices.values(); }
+
+    static QByteArray probeMessage(const QString &messageId);
+    // ProbeMatch feldolgozás; false, ha nem a mi próbánkra jött válasz (RelatesTo) vagy hibás
+    static bool parseProbeMatches(const QByteArray &xml, const QString &messageId, QList<Device> &out);
+
+signals:
+    void deviceFound(const OnvifDiscovery::Device &dev);
+    void deviceUpdated(const OnvifDiscovery::Device &dev); // profilok megérkeztek / hiba
+    void finished();
+
+private:
+    void sendProbe();
+    void readDatagrams();
+    void pumpDetails();
+    void detailsDone(const QString &endpoint);
+    void checkFinished();
+
+    QUdpSocket *m_socket{};
+    QHostAddress m_target{QStringLiteral("239.255.255.250")};
+    quint16 m_targetPort{3702};
+    QString m_user, m_pass;
+    QString m_messageId;
+    QTimer m_collect;  // gyűjtési idő
+    QTimer m_resend;   // UDP: a próbát egyszer megismételjük
+    bool m_running{false};
+    bool m_collecting{false};
+    bool m_fetchDetails{true};
+    int m_maxConcurrent{4};
+
+    QHash<QString, Device> m_devices;      // endpoint → eszköz
+    QList<QString> m_detailQueue;          // még lekérdezendő eszközök
+    QHash<QString, OnvifClient::RequestId> m_inFlight; // endpoint → futó kérés
+};
+
+Q_DECLARE_METATYPE(OnvifDiscovery::Device)
@@ -0,0 +1,298 @@
+#include "qualityscheduler.h"
+#include "videotile.h"
+
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    // becslés: 1 megapixel dekódolása ennyi ms CPU (H.264/H.265 szoftveres dekódolás nagyságrendje)
+    constexpr double kDecodeMsPerMpx = 3.0;
+    // ennyi ms/s konverzió alatt a puszta FPS-plafon nem ér minőségromlást
+    constexpr double kMinConvertGainMs = 1.0;
+}
+
+QualityScheduler &QualityScheduler::instance()
+{
+    // szándékosan nem szabadul fel (mint a ReconnectScheduler)
+    static QualityScheduler *inst = new QualityScheduler;
+    return *inst;
+}
+
+QualityScheduler::QualityScheduler()
+{
+    m_timer.setInterval(m_cfg.tickMs);
+    connect(&m_timer, &QTimer::timeout, this, &QualityScheduler::tick);
+}
+
+void QualityScheduler::setConfig(const Config &c)
+{
+    m_cfg = c;
+    m_cfg.tickMs = qBound(250, m_cfg.tickMs, 60000);
+    m_cfg.cpuBudgetPercent = qBound(5.0, m_cfg.cpuBudgetPercent, 100.0);
+    m_cfg.restoreBelowPercent = qBound(1.0, m_cfg.restoreBelowPercent, m_cfg.cpuBudgetPercent);
+    m_cfg.restoreHoldMs = qMax(0, m_cfg.restoreHoldMs);
+    m_cfg.degradeStepsPerTick = qMax(1, m_cfg.degradeStepsPerTick);
+    m_cfg.reducedFps = qMax(1.0, m_cfg.reducedFps);
+    m_cfg.keyframeFps = qBound(0.1, m_cfg.keyframeFps, m_cfg.reducedFps);
+    m_cfg.settleMs = qBound(0, m_cfg.settleMs, 120000);
+    m_cfg.minDropPercent = qBound(0.0, m_cfg.minDropPercent, 50.0);
+    m_timer.setInterval(m_cfg.tickMs);
+    m_stepAt.invalidate();
+    m_degradeStalled = false;
+    qDebug() << "[QualityScheduler] budget" << m_cfg.cpuBudgetPercent << "% restore below"
+             << m_cfg.restoreBelowPercent << "% enabled" << m_cfg.enabled;
+
+    if (!m_cfg.enabled)
+    {
+        m_timer.stop();
+        // kikapcsolva minden csempe teljes minőségre áll vissza
+        for (const QPointer<VideoTile> &t : std::as_const(m_tiles))
+            if (t)
+                applyTier(t, VideoTile::FullQuality);
+        m_lastCpuPercent = -1.0;
+    }
+    else if (!m_tiles.isEmpty())
+    {
+        m_timer.start();
+    }
+}
+
+double QualityScheduler::tierFpsCap(int tier) const
+{
+    switch (tier)
+    {
+    case VideoTile::ReducedFps:
+    case VideoTile::SubStream:
+        return m_cfg.reducedFps;
+    case VideoTile::KeyframeOnly:
+        return m_cfg.keyframeFps;
+    default:
+        return 0.0;
+    }
+}
+
+void QualityScheduler::watch(VideoTile *tile)
+{
+    if (!tile)
+        return;
+    for (const auto &t : std::as_const(m_tiles))
+        if (t == tile)
+            return;
+    m_tiles << tile;
+    m_degradeStalled = false; // új csempe: lehet újra mit rontani
+    if (m_cfg.enabled && !m_timer.isActive())
+        m_timer.start();
+}
+
+void QualityScheduler::unwatch(VideoTile *tile)
+{
+    m_tiles.removeIf([tile](const QPointer<VideoTile> &t)
+                     { return !t || t == tile; });
+    m_samples.remove(tile);
+    if (m_tiles.isEmpty())
+        m_timer.stop();
+}
+
+qint64 QualityScheduler::processCpuTimeUs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return -1;
+    auto toUs = [](const FILETIME &ft)
+    {
+        ULARGE_INTEGER v;
+        v.LowPart = ft.dwLowDateTime;
+        v.HighPart = ft.dwHighDateTime;
+        return qint64(v.QuadPart / 10); // 100 ns egységek
+    };
+    return toUs(kernel) + toUs(user);
+#else
+    rusage ru{};
+    if (getrusage(RUSAGE_SELF, &ru) != 0)
+        return -1;
+    return qint64(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+#endif
+}
+
+double QualityScheduler::sampleCost(VideoTile *tile, double seconds)
+{
+    // becsült CPU ms / s: dekódolt képpontok (érkezett frame × forrás-méret) + mért konverziós idő
+    Sample &s = m_samples[tile];
+    const quint64 frames = tile->framesArrived();
+    const quint64 convNs = tile->convertNanos();
+    const double fps = (frames >= s.framesArrived) ? (frames - s.framesArrived) / seconds : 0.0;
+    const double convMs = (convNs >= s.convertNs) ? (convNs - s.convertNs) / 1e6 / seconds : 0.0;
+    s.framesArrived = frames;
+    s.convertNs = convNs;
+    s.convertMs = (s.cost <= 0.0) ? convMs : 0.7 * s.convertMs + 0.3 * convMs;
+
+    const double cost = fps * (tile->sourcePixels() / 1e6) * kDecodeMsPerMpx + convMs;
+    s.cost = (s.cost <= 0.0) ? cost : 0.7 * s.cost + 0.3 * cost;
+    return s.cost;
+}
+
+void QualityScheduler::applyTier(VideoTile *tile, int tier)
+{
+    if (tile->qualityTier() == tier)
+        return;
+    qDebug() << "[QualityScheduler]" << tile->name() << "tier" << tile->qualityTier() << "->" << tier
+             << "cpu" << m_lastCpuPercent << "% cost" << m_samples.value(tile).cost << "ms/s";
+    tile->setQualityTier(VideoTile::QualityTier(tier), tierFpsCap(tier));
+}
+
+bool QualityScheduler::tierHelps(VideoTile *tile, int tier) const
+{
+    // a dekódolást csak a profilváltás és a kulcskép-dekódolás csökkenti; az FPS-plafon csak a konverziót
+    if (tile->tierLowersDecode(VideoTile::QualityTier(tier)))
+        return true;
+    return tier == VideoTile::ReducedFps && m_samples.value(tile).convertMs >= kMinConvertGainMs;
+}
+
+int QualityScheduler::nextTier(VideoTile *tile, int tier) const
+{
+    for (int t = tier + 1; t <= VideoTile::KeyframeOnly; ++t)
+        if (tierHelps(tile, t))
+            return t;
+    return -1;
+}
+
+int QualityScheduler::prevTier(VideoTile *tile, int tier) const
+{
+    for (int t = tier - 1; t > VideoTile::FullQuality; --t)
+        if (tierHelps(tile, t))
+            return t;
+    return VideoTile::FullQuality;
+}
+
+void QualityScheduler::tick()
+{
+    const qint64 cpuUs = processCpuTimeUs();
+    if (cpuUs < 0)
+        return;
+    if (!m_wall.isValid() || m_lastCpuUs < 0)
+    {
+        m_wall.start();
+        m_lastCpuUs = cpuUs;
+        return; // az első mintavétel csak kiindulópont
+    }
+    const qint64 wallMs = m_wall.restart();
+    if (wallMs <= 0)
+        return;
+    const double seconds = wallMs / 1000.0;
+    const int cores = qMax(1, QThread::idealThreadCount());
+    m_lastCpuPercent = 100.0 * ((cpuUs - m_lastCpuUs) / 1000.0) / (wallMs * cores);
+    m_lastCpuUs = cpuUs;
+
+    struct Candidate
+    {
+        VideoTile *tile;
+        int prio;
+        int tier;
+        double cost;
+    };
+    QList<Candidate> cands;
+    const QList<QPointer<VideoTile>> tiles = m_tiles; // a hívások közben a lista változhat
+    for (const QPointer<VideoTile> &t : tiles)
+    {
+        if (!t)
+            continue;
+        const double cost = sampleCost(t, seconds);
+        if (t->admissionPriority() >= 2)
+        {
+            applyTier(t, VideoTile::FullQuality); // fókusz: mindig teljes minőség
+            continue;
+        }
+        if (t->suspendLevel() == VideoTile::Stopped)
+            continue; // nem fogyaszt; a szintje folytatáskor érvényes marad
+        cands.append({t, t->admissionPriority(), t->qualityTier(), cost});
+    }
+
+    if (m_lastCpuPercent > m_cfg.cpuBudgetPercent)
+    {
+        // túlterhelés: előbb a háttér, azon belül a még jobb minőségű és drágább csempék
+        m_headroomFor.invalidate();
+        if (m_stepAt.isValid())
+        {
+            if (m_stepAt.elapsed() < m_cfg.settleMs)
+                return; // az előző lépés hatása (al-stream váltás, dekóder) még nem látszik
+            m_stepAt.invalidate();
+            if (m_stepCpuPercent - m_lastCpuPercent < m_cfg.minDropPercent)
+            {
+                qDebug() << "[QualityScheduler] last step gave no measurable drop" << m_stepCpuPercent
+                         << "->" << m_lastCpuPercent << "%, holding";
+                m_degradeStalled = true;
+            }
+        }
+        if (m_degradeStalled)
+            return;
+        std::sort(cands.begin(), cands.end(), [](const Candidate &a, const Candidate &b)
+                  {
+                      if (a.prio != b.prio)
+                          return a.prio < b.prio;
+                      if (a.tier != b.tier)
+                          return a.tier < b.tier;
+                      return a.cost > b.cost; });
+        int steps = m_cfg.degradeStepsPerTick;
+        for (const Candidate &c : std::as_const(cands))
+        {
+            if (steps <= 0)
+                break;
+            const int next = nextTier(c.tile, c.tier);
+            if (next < 0)
+                continue; // ennél a csempénél már semmi sem csökkenti a terhelést
+            applyTier(c.tile, next);
+            --steps;
+        }
+        if (steps < m_cfg.degradeStepsPerTick)
+        {
+            m_stepCpuPercent = m_lastCpuPercent;
+            m_stepAt.start();
+        }
+        return;
+    }
+
+    // a keret alatt: a következő túlterhelésnél újra próbálhatunk rontani
+    m_stepAt.invalidate();
+    m_degradeStalled = false;
+
+    if (m_lastCpuPercent >= m_cfg.restoreBelowPercent)
+    {
+        m_headroomFor.invalidate(); // a két küszöb között nem változtatunk
+        return;
+    }
+
+    // tartós tartalék: egyszerre egy lépés vissza, a legfontosabb, legolcsóbb csempén kezdve
+    if (!m_headroomFor.isValid())
+    {
+        m_headroomFor.start();
+        return;
+    }
+    if (m_headroomFor.elapsed() < m_cfg.restoreHoldMs)
+        return;
+
+    const Candidate *best = nullptr;
+    for (const Candidate &c : std::as_const(cands))
+    {
+        if (c.tier <= VideoTile::FullQuality)
+            continue;
+        if (!best || c.prio > best->prio || (c.prio == best->prio && (c.tier > best->tier || (c.tier == best->tier && c.cost < best->cost))))
+            best = &c;
+    }
+    if (best)
+    {
+        applyTier(best->tile, prevTier(best->tile, best->tier));
+        m_headroomFor.start(); // a következő visszalépés előtt újra kivárjuk a hatását
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+
+class VideoTile;
+
+/*
+ * Fal-szintű minőség-ütemező CPU-keret alapján (egyetlen időzítő az összes csempére).
+ * Mintavételezi a folyamat CPU-használatát és csempénként a becsült költséget
+ * (dekódolt képpont/s + a konverzióval töltött idő). Keret felett a legkevésbé fontos,
+ * legdrágább csempéket lépcsőzetesen rontja:
+ *   FullQuality → ReducedFps → SubStream → KeyframeOnly,
+ * tartós tartalék esetén fordított sorrendben visszaállítja. A fókuszban lévő csempe
+ * mindig teljes minőségű.
+ * Csak olyan szintre lép, ami az adott csempénél tényleg csökkenti a terhelést (al-stream csak
+ * választható profilnál, kulcskép-dekódolás csak libav háttérnél, puszta FPS-plafon csak mérhető
+ * konverziós költségnél). Minden rontás után kivárja a hatását; ha a CPU nem esett mérhetően,
+ * nem ront tovább, amíg a terhelés a keret alá nem kerül.
+ */
+class QualityScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    struct Config
+    {
+        bool enabled = true;
+        int tickMs = 2000;
+        double cpuBudgetPercent = 75.0;   // a gép összes magjának %-ában
+        double restoreBelowPercent = 55.0; // ez alatt lehet visszaállítani (hiszterézis)
+        int restoreHoldMs = 8000;          // ennyi ideig tartó tartalék után lépünk vissza
+        int degradeStepsPerTick = 2;       // egy mintavételnél legfeljebb ennyi rontás
+        double reducedFps = 8.0;           // ReducedFps / SubStream szint FPS-plafonja
+        double keyframeFps = 1.0;          // KeyframeOnly szint FPS-plafonja
+        int settleMs = 4000;               // rontás után ennyit várunk a hatás mérése előtt
+        double minDropPercent = 1.0;       // ennél kisebb CPU-csökkenés = hatástalan lépés
+    };
+
+    static QualityScheduler &instance();
+
+    void setConfig(const Config &c);
+    Config config() const { return m_cfg; }
+
+    void watch(VideoTile *tile);
+    void unwatch(VideoTile *tile);
+
+    // utolsó mintavétel (statisztikához); -1 = még nincs mérés
+    double lastCpuPercent() const { return m_lastCpuPercent; }
+    double tierFpsCap(int tier) const; // 0 = nincs szint szerinti korlát
+
+private:
+    QualityScheduler();
+    Q_DISABLE_COPY(QualityScheduler)
+
+    void tick();
+    static qint64 processCpuTimeUs(); // felhasználói + kernel idő; -1 = nem elérhető
+
+    struct Sample
+    {
+        quint64 framesArrived = 0;
+        quint64 convertNs = 0;
+        double cost = 0.0;      // becsült terhelés (mozgóátlag)
+        double convertMs = 0.0; // ebből a konverzió, ms / s (mozgóátlag)
+    };
+    double sampleCost(VideoTile *tile, double seconds);
+    void applyTier(VideoTile *tile, int tier);
+    bool tierHelps(VideoTile *tile, int tier) const;
+    int nextTier(VideoTile *tile, int tier) const; // -1 = nincs hasznos rosszabb szint
+    int prevTier(VideoTile *tile, int tier) const;
+
+    Config m_cfg;
+    QTimer m_timer;
+    QList<QPointer<VideoTile>> m_tiles;
+    QHash<VideoTile *, Sample> m_samples;
+    QElapsedTimer m_wall;      // két mintavétel között eltelt idő
+    qint64 m_lastCpuUs{-1};
+    double m_lastCpuPercent{-1.0};
+    QElapsedTimer m_headroomFor; // mióta van tartalék (érvénytelen = nincs)
+    QElapsedTimer m_stepAt;      // az utolsó rontás óta (érvénytelen = nincs mérendő lépés)
+    double m_stepCpuPercent{-1.0}; // CPU a rontás pillanatában
+    bool m_degradeStalled{false};  // az utolsó lépés hatástalan volt: nem rontunk tovább
+};
@@ -0,0 +1,233 @@
+#include "reconnectscheduler.h"
+#include "videotile.h"
+
+#include <QRandomGenerator>
+#include <climits>
+#include <QDebug>
+
+ReconnectScheduler &ReconnectScheduler::instance()
+{
+    // szándékosan nem szabadul fel: az időzítők ne a QApplication után bomoljanak le
+    static ReconnectScheduler *inst = new ReconnectScheduler;
+    return *inst;
+}
+
+void ReconnectScheduler::setConfig(const Config &c)
+{
+    m_cfg = c;
+    m_cfg.baseDelayMs = qMax(100, m_cfg.baseDelayMs);
+    m_cfg.maxDelayMs = qMax(m_cfg.baseDelayMs, m_cfg.maxDelayMs);
+    m_cfg.jitter = qBound(0.0, m_cfg.jitter, 0.9);
+    m_cfg.maxHandshakes = qMax(1, m_cfg.maxHandshakes);
+    m_cfg.handshakeTimeoutMs = qMax(1000, m_cfg.handshakeTimeoutMs);
+    m_cfg.quarantineProbeMs = qMax(m_cfg.baseDelayMs, m_cfg.quarantineProbeMs);
+    qDebug() << "[ReconnectScheduler] base" << m_cfg.baseDelayMs << "max" << m_cfg.maxDelayMs
+             << "handshakes" << m_cfg.maxHandshakes << "quarantine after" << m_cfg.quarantineAfterMs;
+    pump(); // nagyobb kapacitás: a várakozók indulhatnak
+}
+
+ReconnectScheduler::Entry &ReconnectScheduler::entryFor(VideoTile *tile)
+{
+    auto it = m_entries.find(tile);
+    if (it != m_entries.end())
+        return it.value();
+
+    Entry &e = m_entries[tile];
+    e.tile = tile;
+    e.inState.start();
+    e.timer = new QTimer(this);
+    e.timer->setSingleShot(true);
+    connect(e.timer, &QTimer::timeout, this, [this, tile]
+            { onTimer(tile); });
+    return e;
+}
+
+void ReconnectScheduler::setState(Entry &e, State s)
+{
+    if (e.state == s)
+        return;
+    e.stats.msInState[e.state] += e.inState.restart();
+    e.state = s;
+}
+
+void ReconnectScheduler::releaseSlot(Entry &e)
+{
+    if (e.state == Handshaking)
+    {
+        m_active = qMax(0, m_active - 1);
+        e.timer->stop();
+    }
+}
+
+int ReconnectScheduler::backoffDelayMs(const Entry &e) const
+{
+    double delay;
+    if (e.state == Quarantined)
+    {
+        delay = m_cfg.quarantineProbeMs;
+    }
+    else
+    {
+        const int exp = qBound(0, e.stats.consecutiveFailures - 1, 16);
+        delay = qMin(double(m_cfg.maxDelayMs), double(m_cfg.baseDelayMs) * double(1 << exp));
+    }
+    // szórás: a kamerák ne ugyanabban a pillanatban próbálkozzanak újra
+    const double r = QRandomGenerator::global()->generateDouble() * 2.0 - 1.0; // -1..1
+    return qMax(100, int(delay * (1.0 + r * m_cfg.jitter)));
+}
+
+void ReconnectScheduler::requestConnect(VideoTile *tile)
+{
+    if (!tile)
+        return;
+    Entry &e = entryFor(tile);
+    if (e.state == Queued || e.state == Handshaking)
+        return;
+    e.timer->stop();
+    setState(e, Queued);
+    m_queue.removeAll(tile);
+    m_queue.append(tile);
+    pump();
+}
+
+void ReconnectScheduler::pump()
+{
+    while (m_active < m_cfg.maxHandshakes && !m_queue.isEmpty())
+    {
+        // elsőbbség: fókusz > látható > háttér; azonos szinten érkezési sorrend
+        qsizetype pick = 0;
+        int bestPrio = INT_MIN;
+        for (qsizetype i = 0; i < m_queue.size(); ++i)
+        {
+            auto e = m_entries.constFind(m_queue[i]);
+            const int prio = (e != m_entries.cend() && e->tile) ? e->tile->admissionPriority() : INT_MIN;
+            if (prio > bestPrio)
+            {
+                bestPrio = prio;
+                pick = i;
+            }
+        }
+        VideoTile *t = m_queue.takeAt(pick);
+        auto it = m_entries.find(t);
+        if (it == m_entries.end() || !it->tile || it->state != Queued)
+            continue;
+
+        setState(*it, Handshaking);
+        ++m_active;
+        ++it->stats.attempts;
+        it->timer->start(m_cfg.handshakeTimeoutMs);
+        // a hívás alatt a hash változhat: utána már nem használjuk az iterátort
+        QPointer<VideoTile> tile = it->tile;
+        tile->beginConnectAttempt();
+    }
+}
+
+void ReconnectScheduler::reportSuccess(VideoTile *tile)
+{
+    auto it = m_entries.find(tile);
+    if (it == m_entries.end() || it->state == Connected)
+        return;
+    releaseSlot(*it);
+    it->timer->stop();
+    ++it->stats.successes;
+    it->stats.consecutiveFailures = 0;
+    it->failingFor.invalidate();
+    setState(*it, Connected);
+    pump();
+}
+
+void ReconnectScheduler::reportFailure(VideoTile *tile)
+{
+    auto it = m_entries.find(tile);
+    // bontás/sorban állás közbeni hibajelzések (pl. setSource(QUrl()) → NoMedia) nem számítanak
+    if (it == m_entries.end() || (it->state != Handshaking && it->state != Connected))
+        return;
+
+    Entry &e = *it;
+    releaseSlot(e);
+    ++e.stats.failures;
+    ++e.stats.consecutiveFailures;
+    if (!e.failingFor.isValid())
+        e.failingFor.start();
+
+    const bool quarantine = e.failingFor.elapsed() >= m_cfg.quarantineAfterMs;
+    if (quarantine)
+        qDebug() << "[ReconnectScheduler] quarantined, slow probe:" << (e.tile ? e.tile->name() : QString());
+    setState(e, quarantine ? Quarantined : Backoff);
+    e.timer->start(backoffDelayMs(e));
+    const QPointer<VideoTile> failing = e.tile;
+    const int consecutive = e.stats.consecutiveFailures;
+    pump();
+    // a fal ebből dönthet pl. a stream-cím újrafeloldásáról
+    if (failing)
+        emit failing->connectFailing(consecutive);
+}
+
+void ReconnectScheduler::cancel(VideoTile *tile)
+{
+    auto it = m_entries.find(tile);
+    if (it == m_entries.end())
+        return;
+    m_queue.removeAll(tile);
+    releaseSlot(*it);
+    it->timer->stop();
+    setState(*it, Idle); // a hibaszámláló megmarad: a backoff a következő hibánál innen folytatódik
+    pump();
+}
+
+void ReconnectScheduler::forget(VideoTile *tile)
+{
+    auto it = m_entries.find(tile);
+    if (it == m_entries.end())
+        return;
+    m_queue.removeAll(tile);
+    releaseSlot(*it);
+    delete it->timer;
+    m_entries.erase(it);
+    pump();
+}
+
+void ReconnectScheduler::onTimer(VideoTile *tile)
+{
+    auto it = m_entries.find(tile);
+    if (it == m_entries.end() || !it->tile)
+        return;
+
+    if (it->state == Handshaking)
+    {
+        // túl sokáig nem jött kép: sikertelen kézfogás, a hely felszabadul
+        qDebug() << "[ReconnectScheduler] handshake timeout:" << it->tile->name();
+        reportFailure(tile);
+        return;
+    }
+    if (it->state == Backoff || it->state == Quarantined)
+    {
+        setState(*it, Idle);
+        QPointer<VideoTile> t = it->tile;
+        t->retryOnce(); // bontás után requestConnect()-tel sorba áll
+    }
+}
+
+ReconnectScheduler::State ReconnectScheduler::stateOf(const VideoTile *tile) const
+{
+    auto it = m_entries.constFind(const_cast<VideoTile *>(tile));
+    return it == m_entries.cend() ? Idle : it->state;
+}
+
+QList<ReconnectScheduler::CameraStats> ReconnectScheduler::snapshot() const
+{
+    QList<CameraStats> out;
+    out.reserve(m_entries.size());
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+    {
+        if (!it->tile)
+            continue;
+        CameraStats s = it->stats;
+        s.name = it->tile->name();
+        s.state = it->state;
+        s.msInState[it->state] += it->inState.elapsed(); // a folyamatban lévő állapot is számít
+        s.nextAttemptInMs = (it->state == Backoff || it->state == Quarantined) ? it->timer->remainingTime() : -1;
+        out << s;
+    }
+    return out;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QString>
+
+class VideoTile;
+
+/*
+ * Központi újrakapcsolódás-ütemező (az összes csempének közös).
+ * - Hiba után exponenciális várakozás (backoff) véletlen szórással (jitter), hogy a
+ *   kamerák ne egyszerre, „ütemre” próbálkozzanak pl. egy switch-újraindulás után.
+ * - Egyszerre legfeljebb N RTSP-kézfogás fut (induláskor is); a többi sorban áll,
+ *   a csempe admissionPriority()-je szerint (fókusz, látható, háttér).
+ * - Sokáig halott kamera „karanténba” kerül: ritka, lassú próbálkozás.
+ * - Kameránként (csempénként) lekérdezhető számlálók: próbák, sikerek, állapotban töltött idő.
+ *
+ * Folyamat: csempe → requestConnect() → (sor) → beginConnectAttempt() a csempén →
+ *           reportSuccess() az első frame-re / reportFailure() hibára → backoff → retryOnce().
+ */
+class ReconnectScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum State
+    {
+        Idle = 0,     // nincs teendő (áll / leállítva / bontás alatt)
+        Queued,       // kézfogásra vár (kapacitás)
+        Handshaking,  // kapcsolódik
+        Connected,    // megy a kép
+        Backoff,      // hiba után vár
+        Quarantined,  // régóta halott: ritka próbálkozás
+        StateCount
+    };
+    Q_ENUM(State)
+
+    struct Config
+    {
+        int baseDelayMs = 2000;          // első újrapróbálás
+        int maxDelayMs = 60000;          // backoff felső korlát
+        double jitter = 0.25;            // ± arány
+        int maxHandshakes = 4;           // egyszerre futó kézfogások
+        int handshakeTimeoutMs = 20000;  // ennyi után a kézfogás sikertelennek számít
+        int quarantineAfterMs = 10 * 60 * 1000; // folyamatos hiba ennyi ideje → karantén
+        int quarantineProbeMs = 5 * 60 * 1000;  // karanténban a próbák távolsága
+    };
+
+    struct CameraStats
+    {
+        QString name;
+        State state = Idle;
+        quint64 attempts = 0;
+        quint64 successes = 0;
+        quint64 failures = 0;
+        int consecutiveFailures = 0;
+        qint64 msInState[StateCount] = {};
+        qint64 nextAttemptInMs = -1; // backoff/karantén alatt: hátralévő idő
+    };
+
+    static ReconnectScheduler &instance();
+
+    void setConfig(const Config &c);
+    Config config() const { return m_cfg; }
+
+    // csempe oldali jelzések
+    void requestConnect(VideoTile *tile);  // kapcsolódna (bontás után): sorba áll
+    void reportSuccess(VideoTile *tile);   // első frame megjött
+    void reportFailure(VideoTile *tile);   // hiba/leállás: backoff után újrapróbálás
+    void cancel(VideoTile *tile);          // leállítva / felfüggesztve: nincs több próbálkozás
+    void forget(VideoTile *tile);          // csempe megszűnik
+
+    State stateOf(const VideoTile *tile) const;
+    QList<CameraStats> snapshot() const;
+    int activeHandshakes() const { return m_active; }
+    int queued() const { return int(m_queue.size()); }
+
+private:
+    ReconnectScheduler() = default;
+    Q_DISABLE_COPY(ReconnectScheduler)
+
+    struct Entry
+    {
+        QPointer<VideoTile> tile;
+        State state = Idle;
+        QElapsedTimer inState;   // az aktuális állapot kezdete óta
+        QElapsedTimer failingFor; // az első (folyamatos) hiba óta
+        QTimer *timer = nullptr; // backoff / kézfogás-időtúllépés
+        CameraStats stats;
+    };
+
+    Entry &entryFor(VideoTile *tile);
+    void setState(Entry &e, State s);
+    void releaseSlot(Entry &e); // ha kézfogásban volt
+    void pump();                // szabad kapacitásra a sor elejéről indít
+    int backoffDelayMs(const Entry &e) const;
+    void onTimer(VideoTile *tile);
+
+    Config m_cfg;
+    QHash<VideoTile *, Entry> m_entries;
+    QList<VideoTile *> m_queue;
+    int m_active{0};
+};
@@ -0,0 +1,108 @@
+#include "streamhub.h"
+#include "streamsource.h"
+#include "util.h"
+
+#include <QDebug>
+
+StreamHub &StreamHub::instance()
+{
+    // szándékosan nem szabadul fel: a források aszinkron bontása túlélheti a csempéket
+    static StreamHub *inst = new StreamHub;
+    return *inst;
+}
+
+StreamSource *StreamHub::acquire(const QUrl &url, int backend, const QString &avOptions)
+{
+    QString key = Util::streamKey(url);
+    if (backend != StreamSource::QtMultimedia)
+        key += QString("|%1|%2").arg(backend).arg(avOptions.trimmed());
+    StreamSource *src = m_byKey.value(key);
+    if (src && !src->hasFailed())
+    {
+        ++m_refs[src];
+        ++m_joins;
+        applyKeyframeOnly(src); // az új feliratkozó minden képet kér
+        qDebug() << "[StreamHub] join" << url.host() << "subscribers=" << m_refs.value(src);
+        return src;
+    }
+
+    // nincs, vagy elhasznált: újat nyitunk (a régit a tartói még elengedik)
+    src = StreamSource::create(StreamSource::Backend(backend), avOptions);
+    m_byKey.insert(key, src);
+    m_refs.insert(src, 1);
+    src->open(url);
+    qDebug() << "[StreamHub] open" << url.host() << "sources=" << m_refs.size();
+    return src;
+}
+
+void StreamHub::release(StreamSource *src, QObject *subscriber)
+{
+    if (!src)
+        return;
+    if (subscriber)
+        src->disconnect(subscriber);
+
+    auto it = m_refs.find(src);
+    if (it == m_refs.end())
+        return;
+    if (subscriber)
+    {
+        auto kf = m_keyframeOnly.find(src);
+        if (kf != m_keyframeOnly.end() && kf->remove(subscriber) && kf->isEmpty())
+            m_keyframeOnly.erase(kf);
+    }
+    if (--it.value() > 0)
+    {
+        applyKeyframeOnly(src);
+        return;
+    }
+
+    m_refs.erase(it);
+    m_keyframeOnly.remove(src);
+    for (auto k = m_byKey.begin(); k != m_byKey.end(); ++k)
+    {
+        if (k.value() == src)
+        {
+            m_byKey.erase(k);
+            break;
+        }
+    }
+    src->release();
+}
+
+void StreamHub::setKeyframeOnly(StreamSource *src, QObject *subscriber, bool on)
+{
+    if (!src || !subscriber || !m_refs.contains(src))
+        return;
+    if (on)
+        m_keyframeOnly[src].insert(subscriber);
+    else if (m_keyframeOnly.contains(src))
+    {
+        m_keyframeOnly[src].remove(subscriber);
+        if (m_keyframeOnly[src].isEmpty())
+            m_keyframeOnly.remove(src);
+    }
+    applyKeyframeOnly(src);
+}
+
+void StreamHub::applyKeyframeOnly(StreamSource *src)
+{
+    const int wanting = int(m_keyframeOnly.value(src).size());
+    src->setKeyframeOnly(wanting > 0 && wanting >= m_refs.value(src));
+}
+
+int StreamHub::subscribers() const
+{
+    int n = 0;
+    for (int r : m_refs)
+        n += r;
+    return n;
+}
+
+int StreamHub::sharedSources() const
+{
+    int n = 0;
+    for (int r : m_refs)
+        n += (r > 1) ? 1 : 0;
+    return n;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QUrl>
+
+class StreamSource;
+
+/*
+ * Közös dekódolás: ugyanaz a forrás (normalizált URL, Util::streamKey) egyszer nyílik meg,
+ * a frame-eket minden feliratkozó csempe megkapja, és a saját méretére/módjára konvertálja.
+ * Referenciaszámlálás: az utolsó leiratkozó után a forrás aszinkron bomlik.
+ * Hibás (elakadt, leállt) forrást nem ad ki újra: az első újrapróbáló csempe újat nyit,
+ * a többiek ahhoz csatlakoznak.
+ */
+class StreamHub : public QObject
+{
+    Q_OBJECT
+public:
+    static StreamHub &instance();
+
+    // megnyitja vagy a már futót adja vissza (refcount + 1); eltérő háttér/opciók = külön forrás
+    StreamSource *acquire(const QUrl &url, int backend = 0, const QString &avOptions = QString());
+    // a hívó jelei leválnak; az utolsó referencia után a forrás bomlik
+    void release(StreamSource *src, QObject *subscriber);
+    // a feliratkozó csak kulcsképeket kér; közös forrás csak akkor vált, ha minden feliratkozója kéri
+    void setKeyframeOnly(StreamSource *src, QObject *subscriber, bool on);
+
+    int openSources() const { return int(m_refs.size()); }
+    int subscribers() const;
+    int sharedSources() const; // több feliratkozós források
+    quint64 joins() const { return m_joins; } // megnyitás helyett csatlakozás
+
+private:
+    StreamHub() = default;
+    Q_DISABLE_COPY(StreamHub)
+
+    void applyKeyframeOnly(StreamSource *src);
+
+    QHash<QString, StreamSource *> m_byKey; // csak az egészséges, kiadható források
+    QHash<StreamSource *, int> m_refs;      // minden élő forrás (a hibásak is, amíg tartják)
+    QHash<StreamSource *, QSet<QObject *>> m_keyframeOnly; // forrás → csak kulcsképet kérő feliratkozók
+    quint64 m_joins{0};
+};
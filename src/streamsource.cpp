@@ -0,0 +1,96 @@
+#include "streamsource.h"
+#ifdef CAMERAWALL_HAVE_LIBAV
+#include "libavsource.h"
+#endif
+
+#include <QtMultimedia/QVideoSink>
+#include <QtMultimedia/QVideoFrame>
+#include <QTimer>
+#include <QDebug>
+
+StreamSource *StreamSource::create(Backend backend, const QString &avOptions)
+{
+#ifdef CAMERAWALL_HAVE_LIBAV
+    if (backend == LibAv)
+        return new LibAvSource(avOptions);
+#else
+    Q_UNUSED(avOptions);
+    if (backend == LibAv)
+        qDebug() << "[StreamSource] libav backend not built in, using QtMultimedia";
+#endif
+    return new MediaPlayerSource;
+}
+
+bool StreamSource::backendAvailable(Backend backend)
+{
+#ifdef CAMERAWALL_HAVE_LIBAV
+    return backend == QtMultimedia || backend == LibAv;
+#else
+    return backend == QtMultimedia;
+#endif
+}
+
+StreamSource::StreamSource(Backend backend, QObject *parent)
+    : QObject(parent), m_backend(backend)
+{
+}
+
+StreamSource::~StreamSource() = default;
+
+void StreamSource::release()
+{
+    // a csempe felé semmi ne menjen tovább (a bontás közbeni NoMedia/Stopped sem)
+    disconnect();
+    // a szülő (csempe) törlése se vigye magával szinkron: a bontás a saját ütemében fut
+    setParent(nullptr);
+    QTimer::singleShot(0, this, [this]
+                       {
+        qDebug() << "[StreamSource] async teardown" << m_url;
+        teardown(); });
+}
+
+MediaPlayerSource::MediaPlayerSource(QObject *parent)
+    : StreamSource(QtMultimedia, parent)
+{
+    m_player = new QMediaPlayer(this);
+    m_sink = new QVideoSink(this);
+    m_player->setVideoSink(m_sink);
+
+    // a saját hibaállapot a továbbított jelek ELŐTT áll be: a jelre újrapróbáló csempe már újat kapjon
+    connect(m_player, &QMediaPlayer::errorOccurred, this, [this]
+            { m_failed = true; });
+    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, [this](QMediaPlayer::MediaStatus st)
+            {
+        if (st == QMediaPlayer::InvalidMedia || st == QMediaPlayer::NoMedia ||
+            st == QMediaPlayer::StalledMedia || st == QMediaPlayer::EndOfMedia)
+            m_failed = true; });
+    connect(m_player, &QMediaPlayer::playbackStateChanged, this, [this](QMediaPlayer::PlaybackState st)
+            {
+        if (st == QMediaPlayer::StoppedState)
+            m_failed = true; });
+
+    connect(m_sink, &QVideoSink::videoFrameChanged, this, &StreamSource::frameArrived);
+    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &StreamSource::mediaStatusChanged);
+    connect(m_player, &QMediaPlayer::errorOccurred, this, &StreamSource::errorOccurred);
+    connect(m_player, &QMediaPlayer::playbackStateChanged, this, &StreamSource::playbackStateChanged);
+}
+
+MediaPlayerSource::~MediaPlayerSource()
+{
+    if (m_player)
+        m_player->setVideoSink(nullptr);
+}
+
+void MediaPlayerSource::open(const QUrl &url)
+{
+    m_url = url;
+    m_player->setSource(url);
+    m_player->play();
+}
+
+void MediaPlayerSource::teardown()
+{
+    m_player->stop();
+    m_player->setSource(QUrl()); // az FFmpeg lezárhatja a régi RTSP-t
+    deleteLater();
+}
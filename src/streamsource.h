@@ -0,0 +1,83 @@
+#pragma once
+#include <QObject>
+#include <QUrl>
+#include <QtMultimedia/QMediaPlayer>
+
+class QVideoSink;
+class QVideoFrame;
+
+/*
+ * Egy megnyitott stream egy URL-hez; a frame-eket QVideoFrame-ként adja a csempéknek.
+ * A csempe minden kapcsolódási kísérlethez a StreamHub-tól kér egyet (azonos URL-nél közöset);
+ * így a régi forrás tovább futhat, amíg az új az első képét nem adja (make-before-break),
+ * és a bontás nem blokkolja a GUI-t.
+ * Háttér (backend): QMediaPlayer (alapértelmezett), vagy – CAMERAWALL_HAVE_LIBAV fordítással –
+ * közvetlen libavformat/libavcodec saját szálon, FFmpeg-opciókkal (LibAvSource).
+ * Az állapotjelek mindkét háttérnél a QMediaPlayer típusait használják, a csempe nem tesz különbséget.
+ */
+class StreamSource : public QObject
+{
+    Q_OBJECT
+public:
+    enum Backend
+    {
+        QtMultimedia = 0, // QMediaPlayer + QVideoSink
+        LibAv = 1         // libavformat/libavcodec saját szálon
+    };
+    Q_ENUM(Backend)
+
+    // avOptions: „kulcs=érték;…” FFmpeg-opciók (csak LibAv); nem elérhető háttérnél QtMultimedia
+    static StreamSource *create(Backend backend, const QString &avOptions = QString());
+    static bool backendAvailable(Backend backend);
+
+    ~StreamSource() override;
+
+    virtual void open(const QUrl &url) = 0;
+    // csak a kulcsképek dekódolása (KeyframeOnly minőségi szint); ahol a háttér nem tudja, hatástalan
+    virtual void setKeyframeOnly(bool on) { Q_UNUSED(on); }
+    virtual bool canSkipNonKeyframes() const { return false; }
+    QUrl url() const { return m_url; }
+    Backend backend() const { return m_backend; }
+
+    // hibát jelzett vagy elakadt (watchdog): a hub nem adja ki újra
+    bool hasFailed() const { return m_failed; }
+    void markFailed() { m_failed = true; }
+
+    // leválasztás és aszinkron bontás: a jelek azonnal megszűnnek, a teardown()
+    // a következő eseményciklusban fut, a hívó ne használja tovább a mutatót
+    void release();
+
+signals:
+    void frameArrived(const QVideoFrame &frame);
+    void mediaStatusChanged(QMediaPlayer::MediaStatus st);
+    void errorOccurred(QMediaPlayer::Error err, const QString &msg);
+    void playbackStateChanged(QMediaPlayer::PlaybackState st);
+
+protected:
+    explicit StreamSource(Backend backend, QObject *parent = nullptr);
+    // leállítás; a végén (akár később, pl. a szál lefutása után) deleteLater()
+    virtual void teardown() = 0;
+
+    QUrl m_url;
+    bool m_failed{false};
+
+private:
+    Backend m_backend;
+};
+
+// alapértelmezett háttér: QMediaPlayer + QVideoSink pár
+class MediaPlayerSource final : public StreamSource
+{
+public:
+    explicit MediaPlayerSource(QObject *parent = nullptr);
+    ~MediaPlayerSource() override;
+
+    void open(const QUrl &url) override; // setSource + play
+
+protected:
+    void teardown() override;
+
+private:
+    QMediaPlayer *m_player{};
+    QVideoSink *m_sink{};
+};
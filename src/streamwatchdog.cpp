@@ -0,0 +1,81 @@
+#include "streamwatchdog.h"
+#include "videotile.h"
+#include "reconnectscheduler.h"
+
+#include <QDebug>
+
+StreamWatchdog &StreamWatchdog::instance()
+{
+    // szándékosan nem szabadul fel (mint a ReconnectScheduler)
+    static StreamWatchdog *inst = new StreamWatchdog;
+    return *inst;
+}
+
+StreamWatchdog::StreamWatchdog()
+{
+    m_timer.setInterval(m_cfg.tickMs);
+    connect(&m_timer, &QTimer::timeout, this, &StreamWatchdog::tick);
+}
+
+void StreamWatchdog::setConfig(const Config &c)
+{
+    m_cfg = c;
+    m_cfg.tickMs = qBound(100, m_cfg.tickMs, 10000);
+    m_cfg.degradedAfterMs = qMax(500, m_cfg.degradedAfterMs);
+    m_cfg.restartAfterMs = qMax(m_cfg.degradedAfterMs, m_cfg.restartAfterMs);
+    m_timer.setInterval(m_cfg.tickMs);
+    if (!m_cfg.enabled)
+        m_timer.stop();
+    else if (!m_tiles.isEmpty())
+        m_timer.start();
+}
+
+void StreamWatchdog::watch(VideoTile *tile)
+{
+    if (!tile)
+        return;
+    for (const auto &t : std::as_const(m_tiles))
+        if (t == tile)
+            return;
+    m_tiles << tile;
+    if (m_cfg.enabled && !m_timer.isActive())
+        m_timer.start();
+}
+
+void StreamWatchdog::unwatch(VideoTile *tile)
+{
+    m_tiles.removeIf([tile](const QPointer<VideoTile> &t)
+                     { return !t || t == tile; });
+    if (m_tiles.isEmpty())
+        m_timer.stop();
+}
+
+void StreamWatchdog::tick()
+{
+    const QList<QPointer<VideoTile>> tiles = m_tiles; // a hívások közben a lista változhat
+    for (const QPointer<VideoTile> &t : tiles)
+    {
+        if (!t || !t->watchdogEligible())
+            continue;
+        // csak élő kapcsolatot figyelünk: backoff / kézfogás alatt az ütemező dolgozik
+        if (ReconnectScheduler::instance().stateOf(t) != ReconnectScheduler::Connected)
+            continue;
+
+        const qint64 silent = t->msSinceLastFrame();
+        if (silent < 0)
+            continue;
+        const double interval = t->expectedFrameIntervalMs();
+        const qint64 degradedAfter = qMax<qint64>(m_cfg.degradedAfterMs, qint64(interval * m_cfg.intervalFactorDegraded));
+        const qint64 restartAfter = qMax<qint64>(m_cfg.restartAfterMs, qint64(interval * m_cfg.intervalFactorRestart));
+
+        if (silent >= restartAfter)
+        {
+            qDebug() << "[StreamWatchdog] frozen stream" << t->name() << silent << "ms -> restart";
+            t->onWatchdogStall();
+        }
+        else if (silent >= degradedAfter)
+        {
+            t->onWatchdogDegraded();
+        }
+    }
+}
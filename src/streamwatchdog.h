@@ -0,0 +1,49 @@
+#pragma once
+#include <QObject>
+#include <QList>
+#include <QPointer>
+#include <QTimer>
+
+class VideoTile;
+
+/*
+ * Fal-szintű frame-érkezés figyelő (egyetlen időzítő az összes csempére).
+ * Sok kamera „befagy” úgy, hogy a QMediaPlayer sem hibát, sem StalledMedia-t nem jelez:
+ * a csempe zöld marad egy álló képpel. Itt a legutóbbi frame óta eltelt időt vetjük össze
+ * a stream várható frame-távolságával:
+ * - degradedAfter után a csempe „lassú/akadozó” állapotú lesz (narancs pötty),
+ * - restartAfter után hibának számít: az újrakapcsolódás-ütemező indítja újra.
+ * Csak a kapcsolódott, nem leállított csempéket figyeli.
+ */
+class StreamWatchdog : public QObject
+{
+    Q_OBJECT
+public:
+    struct Config
+    {
+        bool enabled = true;
+        int tickMs = 1000;
+        int degradedAfterMs = 3000;  // legalább ennyi csend → degradált
+        int restartAfterMs = 10000;  // legalább ennyi csend → újraindítás
+        double intervalFactorDegraded = 10.0; // ill. a várható frame-távolság ennyiszerese
+        double intervalFactorRestart = 30.0;
+    };
+
+    static StreamWatchdog &instance();
+
+    void setConfig(const Config &c);
+    Config config() const { return m_cfg; }
+
+    void watch(VideoTile *tile);
+    void unwatch(VideoTile *tile);
+
+private:
+    StreamWatchdog();
+    Q_DISABLE_COPY(StreamWatchdog)
+
+    void tick();
+
+    Config m_cfg;
+    QTimer m_timer;
+    QList<QPointer<VideoTile>> m_tiles;
+};
@@ -66,6 +66,31 @@ namespace Util
         return ensureRtspCredentials(in, user, pass, /*overwrite=*/false);
     }
 
+    /*
+     * Stream-kulcs a közös dekódoláshoz (StreamHub): ugyanarra a forrásra mutató URL-ek
+     * egyezzenek – kisbetűs séma/host, alapértelmezett port kiírva, ./.. és záró / nélkül.
+     * A hitelesítő adat a kulcs része (más user más streamet kaphat).
+     */
+    inline QString streamKey(const QUrl &in)
+    {
+        QUrl u = in.adjusted(QUrl::NormalizePathSegments | QUrl::StripTrailingSlash);
+        const QString scheme = u.scheme().toLower();
+        u.setScheme(scheme);
+        u.setHost(u.host().toLower());
+        if (u.port() < 0)
+        {
+            if (scheme == "rtsp")
+                u.setPort(554);
+            else if (scheme == "rtsps")
+                u.setPort(322);
+            else if (scheme == "http")
+                u.setPort(80);
+            else if (scheme == "https")
+                u.setPort(443);
+        }
+        return u.toString(QUrl::FullyEncoded);
+    }
+
     /* ---- ONVIF/WSSE segédek ---- */
 
     // Base64
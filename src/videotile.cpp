@@ -1,135 +1,294 @@
 #include "videotile.h"
 #include "language.h"
+#include "frameconverter.h"
+#include "reconnectscheduler.h"
+#include "streamwatchdog.h"
+#include "qualityscheduler.h"
+#include "streamsource.h"
+#include "streamhub.h"
 
 #include <QPainter>
-#include <QVBoxLayout>
-#include <QHBoxLayout>
-#include <QLabel>
-#include <QPushButton>
-#include <QStyle>
 #include <QMouseEvent>
+#include <QHelpEvent>
+#include <QToolTip>
 #include <QtMultimedia/QVideoFrame>
 
-VideoTile::VideoTile(bool limitFps15, QWidget *parent)
-    : QWidget(parent), m_limitFps15(limitFps15)
+VideoTile::VideoTile(double maxFps, QWidget *parent)
+    : QWidget(parent), m_maxFps(qMax(0.0, maxFps))
 {
     setAttribute(Qt::WA_OpaquePaintEvent);
     setAutoFillBackground(false);
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
-    // Player + sink
-    m_player = new QMediaPlayer(this);
-    m_sink = new QVideoSink(this);
-    m_player->setVideoSink(m_sink);
+    // a lejátszó + sink pár kapcsolódásonként jön létre (StreamSource), lásd beginConnectAttempt()
 
-    connect(m_sink, &QVideoSink::videoFrameChanged, this, &VideoTile::onVideoFrameChanged);
-    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &VideoTile::onMediaStatusChanged);
-    connect(m_player, &QMediaPlayer::errorOccurred, this, &VideoTile::onErrorOccurred);
-    connect(m_player, &QMediaPlayer::playbackStateChanged, this, &VideoTile::onPlaybackStateChanged);
-
-    // retry timer (alapból leállítva)
-    m_retryTimer.setSingleShot(true);
-    connect(&m_retryTimer, &QTimer::timeout, this, &VideoTile::retryOnce);
+    // konverzió a GUI szálon kívül; a kész képet jelzés után vesszük át
+    m_converter = new FrameConverter(this);
+    connect(m_converter, &FrameConverter::imageReady, this, &VideoTile::onConvertedImageReady);
+    m_fpsClock.start();
 
     // felület
     rebuildUi();
+
+    StreamWatchdog::instance().watch(this);
+    QualityScheduler::instance().watch(this);
 }
 
-void VideoTile::rebuildUi()
+VideoTile::~VideoTile()
 {
-    // fő layout (0 margó, a képet mi festjük a paintEvent-ben)
-    auto *root = new QVBoxLayout(this);
-    root->setContentsMargins(0, 0, 0, 0);
-    root->setSpacing(0);
-
-    // overlay konténer (HUD)
-    m_overlay = new QWidget(this);
-    m_overlay->setAttribute(Qt::WA_TransparentForMouseEvents);
-    m_overlay->setStyleSheet("background:transparent;");
-    m_overlay->raise();
-
-    // HUD tartalom
-    m_nameLbl = new QLabel(m_overlay);
-    m_nameLbl->setStyleSheet("color:white; font-weight:600; background-color:rgba(0,0,0,110); padding:2px 6px;");
-
-    m_statusDot = new QLabel(m_overlay);
-    m_statusDot->setFixedSize(10, 10);
-    setStatusError(); // kezdetben „nincs stream”
-
-    m_zoomBtn = new QPushButton(u8"⛶", this);
-    m_zoomBtn->setCursor(Qt::PointingHandCursor);
-    m_zoomBtn->setFocusPolicy(Qt::NoFocus);
-    m_zoomBtn->setStyleSheet(
-        "QPushButton{color:white; background-color:rgba(0,0,0,110); border:none; padding:4px 8px;}"
-        "QPushButton:hover{background-color:rgba(0,0,0,170);}");
-    connect(m_zoomBtn, &QPushButton::clicked, this, &VideoTile::onZoomClicked);
-
-    updateTranslations();
-    connect(&Language::instance(), &Language::languageChanged,
-            this, &VideoTile::updateTranslations);
+    // a worker ne dolgozzon egy félig lebontott csempének
+    if (m_converter)
+        m_converter->shutdown();
+    releaseSources();
+    if (m_compositor)
+        m_compositor->forget(this);
+    ReconnectScheduler::instance().forget(this);
+    StreamWatchdog::instance().unwatch(this);
+    QualityScheduler::instance().unwatch(this);
+}
 
+void VideoTile::rebuildUi()
+{
+    // HUD: nincs overlay widget/QLabel/QPushButton – a paintEvent festi cache-elt pixmapokból,
+    // így 64 csempénél sincs több száz gyerek-widget és stíluslap-újraszámolás
+    setMouseTracking(true); // nagyítás gomb hover
     updateHudGeometry();
 
-    m_retryTimer.setSingleShot(true);
-    connect(&m_retryTimer, &QTimer::timeout, this, &VideoTile::retryOnce);
-
     m_teardownDelay.setSingleShot(true);
     connect(&m_teardownDelay, &QTimer::timeout, this, [this]
             {
-        // csak itt állítjuk be újra a forrást, a stop() utáni rövid pihenő után
+        // (bontás után) sorba állunk: a kézfogások számát az ütemező korlátozza
         if (!m_url.isValid() || !m_wantPlay) return;
-        qDebug() << "[VideoTile] teardown gap done -> setSource+play" << m_url;
-        m_player->setSource(m_url);
-        m_player->play(); });
+        ReconnectScheduler::instance().requestConnect(this); });
+}
+
+void VideoTile::beginConnectAttempt()
+{
+    if (!m_url.isValid() || !m_wantPlay)
+    {
+        ReconnectScheduler::instance().cancel(this);
+        return;
+    }
+    qDebug() << "[VideoTile] handshake slot granted -> open" << m_url << "makeBeforeBreak=" << m_makeBeforeBreak;
+    if (!m_hasFrame)
+        setStatus(Connecting);
+
+    // a hub-tól kérünk forrást (azonos URL-nél közös, hibásat nem ad ki);
+    // ha fut régi, az első frame-ig az marad a kép forrása
+    if (m_pending)
+        StreamHub::instance().release(m_pending, this);
+    m_pending = nullptr;
+    StreamSource *src = StreamHub::instance().acquire(m_url, m_backend, m_avOptions);
+    m_handshakeSource = src; // ennek az első frame-je zárja a kézfogást
+    if (src == m_source)
+    {
+        // ugyanaz az ép forrás: nincs mit cserélni, a következő képe zárja a kísérletet
+        StreamHub::instance().release(src, nullptr);
+        m_awaitingFirstFrame = true;
+        return;
+    }
+    m_pending = src;
+    if (m_qualityTier == KeyframeOnly)
+        StreamHub::instance().setKeyframeOnly(src, this, true);
+    connect(src, &StreamSource::frameArrived, this, [this, src](const QVideoFrame &f)
+            { onSourceFrame(src, f); });
+    connect(src, &StreamSource::mediaStatusChanged, this, [this, src](QMediaPlayer::MediaStatus st)
+            { onMediaStatusChanged(src, st); });
+    connect(src, &StreamSource::errorOccurred, this, [this, src](QMediaPlayer::Error err, const QString &msg)
+            { onErrorOccurred(src, err, msg); });
+    connect(src, &StreamSource::playbackStateChanged, this, [this, src](QMediaPlayer::PlaybackState st)
+            { onPlaybackStateChanged(src, st); });
 }
 
-void VideoTile::updateTranslations()
+void VideoTile::swapInPending()
 {
-    if (m_zoomBtn)
-        m_zoomBtn->setToolTip(Language::instance().t("menu.zoom", "Zoom IN/OUT"));
+    // az új kapcsolat első képe: innentől ez a forrás, a régi a háttérben bomlik
+    if (m_source)
+        StreamHub::instance().release(m_source, this);
+    m_source = m_pending;
+    m_pending = nullptr;
+    m_converter->clear();     // a régi forrás még konvertálás alatti képe ne számítson az újénak
+    resetFpsGovernor();       // az új stream időbélyegei elölről indulnak
+    m_awaitingFirstFrame = true;
+    m_lastFrameClock.invalidate();
+    m_frameIntervalMs = 0.0;
+}
+
+void VideoTile::releaseSources()
+{
+    if (m_pending)
+        StreamHub::instance().release(m_pending, this);
+    if (m_source)
+        StreamHub::instance().release(m_source, this);
+    m_pending = nullptr;
+    m_source = nullptr;
+}
+
+
+namespace
+{
+    constexpr int kHudPad = 8;
+    constexpr int kDot = 10;
+    constexpr int kDotGap = 6;
+
+    QColor statusColor(VideoTile::Status s)
+    {
+        switch (s)
+        {
+        case VideoTile::Ok:
+            return QColor("#4caf50"); // zöld
+        case VideoTile::Connecting:
+            return QColor("#ffca28"); // amber/sárga
+        case VideoTile::Stalled:
+            return QColor("#ff7043"); // narancs: él a kapcsolat, de nem jön kép
+        case VideoTile::Error:
+        default:
+            return QColor("#f44336"); // piros
+        }
+    }
+
+    QFont nameFont(const QFont &base)
+    {
+        QFont f(base);
+        f.setWeight(QFont::DemiBold);
+        return f;
+    }
 }
 
 void VideoTile::updateHudGeometry()
 {
-    if (!m_overlay)
-        return;
-    m_overlay->setGeometry(rect());
+    // név-címke: pötty + szöveg (2px 6px belső margó), bal felül
+    const QFontMetrics fm(nameFont(font()));
+    const int textH = fm.height() + 4;
+    const QString text = hudText();
+    const int textW = text.isEmpty() ? 0 : fm.horizontalAdvance(text) + 12;
+    m_nameRect = QRect(kHudPad, kHudPad, kDot + kDotGap + textW, qMax(textH, kDot));
+
+    // nagyítás gomb: jobb felül (4px 8px belső margó)
+    const QFontMetrics zfm(font());
+    const QSize z(zfm.horizontalAdvance(QString::fromUtf8(u8"⛶")) + 16, zfm.height() + 8);
+    m_zoomRect = QRect(QPoint(width() - z.width() - kHudPad, kHudPad), z);
+}
+
+void VideoTile::invalidateHud()
+{
+    m_namePlate = QPixmap();
+    m_zoomGlyph[0] = QPixmap();
+    m_zoomGlyph[1] = QPixmap();
+    updateHudGeometry();
+}
+
+const QPixmap &VideoTile::namePlate()
+{
+    if (!m_namePlate.isNull())
+        return m_namePlate;
+
+    const qreal dpr = devicePixelRatioF();
+    m_namePlate = QPixmap((QSizeF(m_nameRect.size()) * dpr).toSize());
+    m_namePlate.setDevicePixelRatio(dpr);
+    m_namePlate.fill(Qt::transparent);
+
+    QPainter p(&m_namePlate);
+    p.setRenderHint(QPainter::Antialiasing);
+    const int h = m_nameRect.height();
+    p.setPen(Qt::NoPen);
+    p.setBrush(statusColor(m_status));
+    p.drawEllipse(QRectF(0, (h - kDot) / 2.0, kDot, kDot));
+
+    const QString text = hudText();
+    if (!text.isEmpty())
+    {
+        const QRect textRect(kDot + kDotGap, 0, m_nameRect.width() - kDot - kDotGap, h);
+        p.fillRect(textRect, QColor(0, 0, 0, 110));
+        p.setFont(nameFont(font()));
+        p.setPen(Qt::white);
+        p.drawText(textRect.adjusted(6, 2, -6, -2), Qt::AlignLeft | Qt::AlignVCenter, text);
+    }
+    return m_namePlate;
+}
 
-    const int pad = 8;
+const QPixmap &VideoTile::zoomGlyph(bool hover)
+{
+    QPixmap &pm = m_zoomGlyph[hover ? 1 : 0];
+    if (!pm.isNull())
+        return pm;
+
+    const qreal dpr = devicePixelRatioF();
+    pm = QPixmap((QSizeF(m_zoomRect.size()) * dpr).toSize());
+    pm.setDevicePixelRatio(dpr);
+    pm.fill(QColor(0, 0, 0, hover ? 170 : 110));
+
+    QPainter p(&pm);
+    p.setFont(font());
+    p.setPen(Qt::white);
+    p.drawText(QRect(QPoint(0, 0), m_zoomRect.size()), Qt::AlignCenter, QString::fromUtf8(u8"⛶"));
+    return pm;
+}
 
-    QSize nameSz = m_nameLbl->sizeHint();
-    const int dot = m_statusDot->height();
-    m_statusDot->move(pad, pad + (nameSz.height() - dot) / 2);
-    m_nameLbl->move(pad + dot + 6, pad);
-    m_nameLbl->resize(nameSz);
+void VideoTile::paintHud(QPainter &p)
+{
+    // másik képernyőre húzva más a dpr: a pixmapok újraépülnek
+    if (!m_namePlate.isNull() && !qFuzzyCompare(m_namePlate.devicePixelRatio(), devicePixelRatioF()))
+        invalidateHud();
+    p.drawPixmap(m_nameRect.topLeft(), namePlate());
+    p.drawPixmap(m_zoomRect.topLeft(), zoomGlyph(m_zoomHover));
+}
 
-    QSize z = m_zoomBtn->sizeHint();
-    m_zoomBtn->move(width() - z.width() - pad, pad);
-    m_zoomBtn->resize(z);
+void VideoTile::setStatus(Status s)
+{
+    if (m_status == s)
+        return; // frame-enként hívódik: változás nélkül semmi munka
+    m_status = s;
+    m_namePlate = QPixmap();
+    update(m_nameRect);
+}
+
+QString VideoTile::hudText() const
+{
+    // csökkentett minőségi szint: a név mellett „▾szint” jelzi (pl. „Udvar ▾2”)
+    if (m_qualityTier == FullQuality)
+        return m_name;
+    const QString tier = QString::fromUtf8(u8"▾%1").arg(int(m_qualityTier));
+    return m_name.isEmpty() ? tier : m_name + QLatin1Char(' ') + tier;
 }
 
 void VideoTile::setName(const QString &n)
 {
+    if (m_name == n)
+        return;
     m_name = n;
-    if (m_nameLbl)
-    {
-        m_nameLbl->setText(m_name);
-        m_nameLbl->adjustSize();
-        updateHudGeometry();
-    }
+    const QRect old = m_nameRect;
+    invalidateHud();
+    update(old.united(m_nameRect));
 }
 
 void VideoTile::playUrl(const QUrl &url)
 {
+    if (m_suspend == Stopped)
+    {
+        // leállítva: csak megjegyezzük, a folytatáskor indul
+        m_url = url;
+        m_resumeWanted = true;
+        m_ttffClock.invalidate();
+        return;
+    }
+
     m_url = url;
+    m_ttffClock.start(); // első frame idejének mérése
     m_wantPlay = true;
 
-    m_hasFrame = false; // ne őrizze meg az utolsó képet
-    m_frame = QImage();
-    setStatusConnecting(); // tényleg most kezd próbálkozni
-    update();
+    if (!m_makeBeforeBreak)
+    {
+        m_hasFrame = false; // ne őrizze meg az utolsó képet
+        m_frame = QImage();
+        m_converter->clear();
+        setStatus(Connecting); // tényleg most kezd próbálkozni
+        update();
+    }
+    // make-before-break: profilváltásnál az eddigi kép marad, amíg az új stream első képe megjön
 
     m_retryCount = 0; // új URL: kudarcszámláló nullázása
+    resetFpsGovernor();
     restartStream();
 }
 
@@ -138,22 +297,49 @@ void VideoTile::restartStream()
     if (!m_url.isValid())
         return;
 
-    qDebug() << "[VideoTile] restartStream() -> stop, clear, delay, then play" << m_url;
+    // bontás alatt a hibajelzések (NoMedia stb.) ne számítsanak kudarcnak
+    ReconnectScheduler::instance().cancel(this);
+    if (m_pending)
+    {
+        StreamHub::instance().release(m_pending, this); // félbehagyott korábbi kísérlet
+        m_pending = nullptr;
+    }
+
+    if (m_makeBeforeBreak && m_hasFrame)
+    {
+        // make-before-break: a régi forrás (és az utolsó kép) marad, amíg az új első képe meg nem jön;
+        // a csempe „elavult” jelzést kap, fekete rés nincs
+        qDebug() << "[VideoTile] restartStream() -> open alongside, keep last frame" << m_url;
+        m_awaitingFirstFrame = false;
+        m_lastFrameClock.invalidate();
+        setStatus(Stalled);
+        m_teardownDelay.start(0);
+        return;
+    }
 
-    m_retryTimer.stop(); // ne fusson párhuzamosan
-    m_player->stop();
+    qDebug() << "[VideoTile] restartStream() -> release, clear, delay, then play" << m_url;
 
-    // teljes forrás-ürítés, hogy az FFmpeg lezárhassa a régi RTSP-t
-    m_player->setSource(QUrl());
+    // a régi pár a háttérben áll le, az FFmpeg lezárhatja a régi RTSP-t
+    if (m_source)
+    {
+        StreamHub::instance().release(m_source, this);
+        m_source = nullptr;
+    }
 
     // UI: nincs kép a próbálkozás alatt
     m_hasFrame = false;
+    m_awaitingFirstFrame = true;
     m_frame = QImage();
-    setStatusConnecting();
+    m_converter->clear();
+    resetFpsGovernor(); // az új stream időbélyegei elölről indulnak
+    m_lastFrameClock.invalidate();
+    m_frameIntervalMs = 0.0;
+    setStatus(Connecting);
     update();
 
-    // rövid szünet a teardown-nak, utána setSource()+play
-    m_teardownDelay.start(400); // 400 ms elég szokott lenni
+    // rövid szünet a teardown-nak (egy-kapcsolatos kamerák), utána nyitás;
+    // make-before-break módban nincs mit kivárni
+    m_teardownDelay.start(m_makeBeforeBreak ? 0 : 400);
 }
 
 void VideoTile::scheduleRetry()
@@ -161,14 +347,9 @@ void VideoTile::scheduleRetry()
     if (!m_wantPlay || !m_url.isValid())
         return;
 
-    if (m_retryTimer.isActive())
-    {
-        qDebug() << "[VideoTile] scheduleRetry: already active";
-        return;
-    }
-
-    setStatusError();         // hiba állapot a várakozás alatt
-    m_retryTimer.start(5000); // 5 mp múlva retry
+    setStatus(Error); // hiba állapot a várakozás alatt
+    // backoff + jitter az ütemezőben; ha már várakozik, a többszöri jelzés nem számít
+    ReconnectScheduler::instance().reportFailure(this);
 }
 
 void VideoTile::retryOnce()
@@ -180,97 +361,443 @@ void VideoTile::retryOnce()
     if (!m_wantPlay || !m_url.isValid())
         return;
 
-    // bizonyos számú kudarc után teljes pipeline újraépítése
-    if (++m_retryCount % m_recreateEvery == 0)
-        recreatePipeline();
-
-    setStatusConnecting(); // most tényleg próbálkozik (sárga)
+    // minden kísérlet friss lejátszó/sink párral indul, külön újraépítés nem kell
+    ++m_retryCount;
+    if (!m_hasFrame)
+        setStatus(Connecting); // most tényleg próbálkozik (sárga)
     restartStream();
 }
 
+void VideoTile::onWatchdogDegraded()
+{
+    if (m_status != Ok)
+        return; // csak egy élő képről váltunk narancsra (és csak egyszer)
+    ++m_stallsDetected;
+    setStatus(Stalled); // a következő konvertált frame visszaállítja zöldre
+}
+
+void VideoTile::onWatchdogStall()
+{
+    if (!m_wantPlay || !m_url.isValid())
+        return;
+    ++m_watchdogRestarts;
+    if (m_source)
+        m_source->markFailed(); // közös forrásnál a többi csempe se csatlakozzon újra ehhez
+    m_lastFrameClock.invalidate(); // a következő kapcsolatig nem figyeljük
+    // hibának számít: a backoff és a kézfogás-korlát az ütemezőben
+    scheduleRetry();
+}
+
 void VideoTile::stop()
 {
     m_wantPlay = false;
-    m_retryTimer.stop();
-
-    if (m_player)
-        m_player->stop();
+    m_resumeWanted = false;
+    m_ttffClock.invalidate();
+    m_lastFrameClock.invalidate();
+    ReconnectScheduler::instance().cancel(this);
+    m_teardownDelay.stop();
+    releaseSources();
 
     m_hasFrame = false;
     m_frame = QImage();
-    setStatusError(); // piros
+    m_converter->clear();
+    setStatus(Error); // piros
     update();
 }
 
-void VideoTile::onVideoFrameChanged(const QVideoFrame &frame)
+void VideoTile::onSourceFrame(StreamSource *src, const QVideoFrame &frame)
 {
     if (!frame.isValid())
         return;
 
-    QVideoFrame f(frame);
-    if (!f.map(QVideoFrame::ReadOnly))
+    if (src == m_pending)
+        swapInPending(); // atomikus csere az új kapcsolat első frame-jén
+    else if (src != m_source)
+        return;          // már leválasztott forrás késve érkező frame-je
+
+    // amíg új kapcsolat épül, a régi forrás képei élőben látszanak, de nem számítanak „első frame”-nek
+    if (m_ttffClock.isValid() && !m_pending)
+    {
+        // az első érvényes frame: a sorban állás + kézfogás + probe teljes ideje
+        m_ttffLastMs = m_ttffClock.elapsed();
+        m_ttffBestMs = (m_ttffBestMs < 0) ? m_ttffLastMs : qMin(m_ttffBestMs, m_ttffLastMs);
+        m_ttffWorstMs = qMax(m_ttffWorstMs, m_ttffLastMs);
+        m_ttffClock.invalidate();
+        qDebug() << "[VideoTile] time-to-first-frame" << m_name << m_ttffLastMs << "ms";
+    }
+
+    // a kézfogás sikere az első forrás-frame, NEM az első konvertált kép: a háttérben (SkipConvert)
+    // vagy rejtett falnál újrakapcsolódó csempe nem konvertál, mégsem futhat kézfogás-időtúllépésbe
+    // (az bontaná az ép streamet, és backoff / újrafeloldás / karantén lenne a vége)
+    if (m_handshakeSource && src == m_handshakeSource)
+    {
+        m_handshakeSource = nullptr;
+        m_retryCount = 0;
+        ReconnectScheduler::instance().reportSuccess(this); // a kézfogás-hely felszabadul
+    }
+
+    // watchdog: minden érkező frame számít, a felfüggesztett/FPS miatt eldobottak is
+    if (m_lastFrameClock.isValid())
+    {
+        const double dt = qBound(1.0, double(m_lastFrameClock.elapsed()), 5000.0);
+        m_frameIntervalMs = (m_frameIntervalMs <= 0.0) ? dt : 0.9 * m_frameIntervalMs + 0.1 * dt;
+    }
+    m_lastFrameClock.start();
+    ++m_framesArrived; // a minőség-ütemező dekódolási költségbecsléséhez
+    m_sourcePixels = qint64(frame.width()) * frame.height();
+
+    // háttérben: a kapcsolat él, de nem konvertálunk és nem festünk
+    if (m_suspend != Active)
+    {
+        ++m_framesSkippedSuspended;
+        return;
+    }
+
+    // FPS-korlát (kamera / rács vagy minőségi szint szerint): a felesleges frame-et még konverzió előtt eldobjuk
+    const double fps = effectiveMaxFps();
+    if (fps > 0.0 && !acceptFrameForFps(frame, fps))
+    {
+        ++m_framesSkippedByFps;
+        return;
+    }
+
+    // csak postaládába tesszük – a map()/toImage() a worker szálon fut
+    m_converter->submit(frame);
+}
+
+bool VideoTile::acceptFrameForFps(const QVideoFrame &frame, double maxFps)
+{
+    // időbélyeg µs-ban; ha a backend nem ad, a saját óránkat használjuk
+    qint64 ts = frame.startTime();
+    if (ts < 0)
+        ts = m_fpsClock.nsecsElapsed() / 1000;
+
+    const qint64 interval = qint64(1000000.0 / maxFps);
+    const qint64 tolerance = interval / 10; // időbélyeg-jitter elnyelése
+
+    // első frame, vagy visszaugrott/ugrott az időbélyeg (újraindulás, wrap)
+    if (m_nextFrameDueUs < 0 || ts < m_lastFrameTsUs || ts - m_lastFrameTsUs > 4 * interval + 1000000)
+    {
+        m_lastFrameTsUs = ts;
+        m_nextFrameDueUs = ts + interval;
+        return true;
+    }
+    m_lastFrameTsUs = ts;
+
+    if (ts + tolerance < m_nextFrameDueUs)
+        return false;
+
+    // rácsra igazított ütemezés: átlagban pontosan a cél-FPS jön át
+    m_nextFrameDueUs += interval;
+    if (m_nextFrameDueUs <= ts)
+        m_nextFrameDueUs = ts + interval; // lemaradás esetén nem „pótolunk” sorozatban
+    return true;
+}
+
+void VideoTile::resetFpsGovernor()
+{
+    m_nextFrameDueUs = -1;
+    m_lastFrameTsUs = -1;
+}
+
+void VideoTile::setMaxFps(double fps)
+{
+    fps = qMax(0.0, fps);
+    if (qFuzzyCompare(fps + 1.0, m_maxFps + 1.0))
+        return;
+    m_maxFps = fps;
+    resetFpsGovernor();
+    qDebug() << "[VideoTile] setMaxFps =" << m_maxFps << m_name;
+}
+
+double VideoTile::effectiveMaxFps() const
+{
+    if (m_tierFpsCap <= 0.0)
+        return m_maxFps;
+    return (m_maxFps <= 0.0) ? m_tierFpsCap : qMin(m_maxFps, m_tierFpsCap);
+}
+
+void VideoTile::setQualityTier(QualityTier tier, double fpsCap)
+{
+    fpsCap = qMax(0.0, fpsCap);
+    if (m_qualityTier == tier && qFuzzyCompare(fpsCap + 1.0, m_tierFpsCap + 1.0))
+        return;
+    const QualityTier prev = m_qualityTier;
+    m_qualityTier = tier;
+    m_tierFpsCap = fpsCap;
+    resetFpsGovernor();
+    if ((prev == KeyframeOnly) != (tier == KeyframeOnly))
+    {
+        // a dekóder maga hagyja ki a köztes képeket (ahol a háttér tudja; közös forrásnál csak ha mindenki kéri)
+        StreamHub::instance().setKeyframeOnly(m_source, this, tier == KeyframeOnly);
+        StreamHub::instance().setKeyframeOnly(m_pending, this, tier == KeyframeOnly);
+        // a frame-távolság nagyságrendet vált (GOP): a watchdog a következő képtől méri újra
+        m_lastFrameClock.invalidate();
+        m_frameIntervalMs = 0.0;
+    }
+
+    const QRect old = m_nameRect;
+    invalidateHud();
+    update(old.united(m_nameRect));
+    if (prev != tier)
+        emit qualityTierChanged(tier); // a fal dönt az al-streamre váltásról
+}
+
+bool VideoTile::tierLowersDecode(QualityTier tier) const
+{
+    switch (tier)
+    {
+    case SubStream:
+        return m_subStreamAvailable;
+    case KeyframeOnly:
+    {
+        const StreamSource *src = m_source ? m_source : m_pending;
+        if (src)
+            return src->canSkipNonKeyframes();
+        return m_backend == StreamSource::LibAv && StreamSource::backendAvailable(StreamSource::LibAv);
+    }
+    default:
+        return false; // az FPS-plafon a dekódolás után dob el: csak a konverziót csökkenti
+    }
+}
+
+quint64 VideoTile::convertNanos() const
+{
+    return m_converter ? m_converter->convertNanos() : 0;
+}
+
+void VideoTile::setSuspendLevel(SuspendLevel level)
+{
+    if (m_suspend == level)
         return;
+    const SuspendLevel prev = m_suspend;
+    m_suspend = level;
+    qDebug() << "[VideoTile] setSuspendLevel" << m_name << prev << "->" << level;
 
-    QImage img = f.toImage();
-    f.unmap();
+    if (level == Stopped)
+    {
+        // teljes leállítás: a retry/teardown se indítsa újra a háttérben
+        m_resumeWanted = m_wantPlay;
+        m_wantPlay = false;
+        ReconnectScheduler::instance().cancel(this);
+        m_teardownDelay.stop();
+        m_lastFrameClock.invalidate();
+        releaseSources();
+        m_converter->clear();
+        m_hasFrame = false;
+        m_frame = QImage();
+        setStatus(Connecting);
+        return;
+    }
 
-    if (!img.isNull())
+    if (prev == Stopped && m_resumeWanted && m_url.isValid())
     {
-        m_frame = img.convertToFormat(QImage::Format_RGB32);
-        m_hasFrame = true;
-        setStatusOk();    // csak tényleges frame-re lesz zöld
-        m_retryCount = 0; // siker: nullázás
+        m_resumeWanted = false;
+        m_wantPlay = true;
+        m_retryCount = 0;
+        m_ttffClock.start(); // folytatás: új megnyitás, újra mérünk
+        restartStream();
+    }
+    // SkipConvert → Active: a következő frame már konvertálódik, addig az utolsó kép látszik
+}
+
+void VideoTile::onConvertedImageReady()
+{
+    QImage img;
+    ConvertTarget madeFor;
+    if (!m_converter->takeImage(img, &madeFor) || img.isNull())
+        return;
+
+    const bool first = m_awaitingFirstFrame;
+    m_awaitingFirstFrame = false;
+    m_frame = std::move(img);
+    m_frameTarget = madeFor;
+    m_hasFrame = true;
+    setStatus(m_pending ? Stalled : Ok); // csak tényleges frame-re lesz zöld; csere alatt elavult
+    if (m_compositor)
+        m_compositor->markDirty(this); // a következő fal-ütemben, a többi csempével együtt
+    else
         update();
+    if (first)
+        emit firstFrameReady(); // a kézfogás sikerét már az onSourceFrame jelezte
+}
+
+quint64 VideoTile::framesConverted() const
+{
+    return m_converter ? m_converter->convertedFrames() : 0;
+}
+
+quint64 VideoTile::framesDroppedInMailbox() const
+{
+    return m_converter ? m_converter->droppedInMailbox() : 0;
+}
+
+quint64 VideoTile::framesDroppedUnpainted() const
+{
+    return m_converter ? m_converter->droppedUnpainted() : 0;
+}
+
+VideoTile::SourceFailure VideoTile::acceptSourceFailure(StreamSource *src)
+{
+    if (src == m_pending)
+    {
+        // az új kapcsolat bukott el: eldobjuk, a régi (ha él) tovább ad képet
+        StreamHub::instance().release(m_pending, this);
+        m_pending = nullptr;
+        m_handshakeSource = nullptr;
+        return m_source ? PendingFailed : SourceFailed;
+    }
+    if (src != m_source)
+        return IgnoredFailure;
+    if (m_pending)
+    {
+        // a lecserélés alatt álló régi forrás halt meg: elengedjük, az utolsó kép marad
+        StreamHub::instance().release(m_source, this);
+        m_source = nullptr;
+        return IgnoredFailure;
     }
+    return SourceFailed;
+}
+
+void VideoTile::requeuePending()
+{
+    // make-before-break: csak az új kapcsolat bukott el, a régi tovább ad képet,
+    // ezért az állapot (Ok/Stalled) marad; az ütemező backoff után újra megnyitja mellette
+    if (!m_wantPlay || !m_url.isValid())
+        return;
+    ReconnectScheduler::instance().reportFailure(this);
 }
 
-void VideoTile::onMediaStatusChanged(QMediaPlayer::MediaStatus st)
+void VideoTile::onMediaStatusChanged(StreamSource *src, QMediaPlayer::MediaStatus st)
 {
-    qDebug() << "[VideoTile] mediaStatusChanged:" << st << " hadFrame=" << m_hasFrame;
+    qDebug() << "[VideoTile] mediaStatusChanged:" << st << " hadFrame=" << m_hasFrame << " pending=" << (src == m_pending);
 
     switch (st)
     {
     case QMediaPlayer::LoadingMedia:
     case QMediaPlayer::BufferingMedia:
-        if (!m_hasFrame)
-            setStatusConnecting();
+        if (!m_hasFrame && src == m_pending)
+            setStatus(Connecting);
         break;
     case QMediaPlayer::InvalidMedia:
     case QMediaPlayer::NoMedia:
-        setStatusError();
-        scheduleRetry();
+        switch (acceptSourceFailure(src))
+        {
+        case IgnoredFailure:
+            break;
+        case PendingFailed:
+            requeuePending();
+            break;
+        case SourceFailed:
+            setStatus(Error);
+            scheduleRetry();
+            break;
+        }
         break;
     case QMediaPlayer::StalledMedia:
     case QMediaPlayer::EndOfMedia:
-        setStatusConnecting();
-        scheduleRetry();
+        switch (acceptSourceFailure(src))
+        {
+        case IgnoredFailure:
+            break;
+        case PendingFailed:
+            requeuePending();
+            break;
+        case SourceFailed:
+            setStatus(m_hasFrame ? Stalled : Connecting);
+            scheduleRetry();
+            break;
+        }
         break;
     default:
         break; // zöldet csak frame érkezésekor állítunk
     }
 }
 
-void VideoTile::onErrorOccurred(QMediaPlayer::Error err, const QString &msg)
+void VideoTile::onErrorOccurred(StreamSource *src, QMediaPlayer::Error err, const QString &msg)
 {
     qDebug() << "[VideoTile] onErrorOccurred:" << err << msg;
-    setStatusError();
-    scheduleRetry(); // ha már aktív, nem indít új időzítőt
+    switch (acceptSourceFailure(src))
+    {
+    case IgnoredFailure:
+        break;
+    case PendingFailed:
+        requeuePending();
+        break;
+    case SourceFailed:
+        setStatus(Error);
+        scheduleRetry(); // ha már aktív, nem indít új időzítőt
+        break;
+    }
 }
 
-void VideoTile::onPlaybackStateChanged(QMediaPlayer::PlaybackState st)
+void VideoTile::onPlaybackStateChanged(StreamSource *src, QMediaPlayer::PlaybackState st)
 {
     qDebug() << "[VideoTile] playbackStateChanged:" << st;
-    if (st == QMediaPlayer::StoppedState && m_wantPlay)
+    if (st != QMediaPlayer::StoppedState || !m_wantPlay)
+        return;
+    // ha akaratunk ellenére leállt, ütemezzük az újrapróbát
+    switch (acceptSourceFailure(src))
     {
-        // ha akaratunk ellenére leállt, ütemezzük az újrapróbát
+    case IgnoredFailure:
+        break;
+    case PendingFailed:
+        requeuePending();
+        break;
+    case SourceFailed:
         scheduleRetry();
+        break;
     }
 }
 
+ConvertTarget VideoTile::currentTarget() const
+{
+    ConvertTarget t;
+    t.viewport = m_viewport;
+    t.dpr = devicePixelRatioF();
+    t.size = (QSizeF(size()) * t.dpr).toSize();
+    switch (m_aspectMode)
+    {
+    case Stretch:
+        t.mode = ConvertTarget::Stretch;
+        break;
+    case Fill:
+        t.mode = ConvertTarget::Fill;
+        break;
+    case Fit:
+    default:
+        t.mode = ConvertTarget::Fit;
+        break;
+    }
+    return t;
+}
+
+void VideoTile::updateConverterTarget()
+{
+    if (m_converter)
+        m_converter->setTarget(currentTarget());
+}
+
+const QImage &VideoTile::scaledFrame(const ConvertTarget &t)
+{
+    // a konverter már erre a célra skálázott: sima blit
+    if (m_frameTarget == t)
+        return m_frame;
+
+    // átméretezés/módváltás után az új frame-ig: egyszer skálázunk, utána cache-ből rajzolunk
+    // (viewport-váltásnál az új frame-ig a régi kivágás látszik)
+    if (m_scaledCache.isNull() || m_scaledCacheKey != m_frame.cacheKey() || m_scaledCacheTarget != t)
+    {
+        m_scaledCache = FrameConverter::scaleForTarget(m_frame, t);
+        m_scaledCacheKey = m_frame.cacheKey();
+        m_scaledCacheTarget = t;
+    }
+    return m_scaledCache;
+}
+
 void VideoTile::paintEvent(QPaintEvent *)
 {
     QPainter p(this);
-    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
 
     // --- háttér és "No Image…" ha nincs frame ---
     if (!m_hasFrame || m_frame.isNull())
@@ -279,84 +806,40 @@ void VideoTile::paintEvent(QPaintEvent *)
         p.setPen(QColor("#5e6a7a"));
         p.drawText(rect(), Qt::AlignCenter,
                    Language::instance().t("status.noimage", "No Image…"));
+        paintHud(p);
         return;
     }
 
     const QRect target = this->rect();
+    const QImage &img = scaledFrame(currentTarget());
 
-    // --- Stretch: kitöltés torzítással, nincs oldalarány-megőrzés ---
-    if (m_aspectMode == Stretch) // VideoTile::Stretch
-    {
-        p.fillRect(target, Qt::black);
-        // Skálázunk célméretre oldalarány figyelmen kívül hagyásával
-        const QImage scaled = m_frame.scaled(target.size(),
-                                             Qt::IgnoreAspectRatio,
-                                             Qt::SmoothTransformation);
-        const QPoint topLeft(target.center() - QPoint(scaled.width() / 2, scaled.height() / 2));
-        p.drawImage(QRect(topLeft, scaled.size()), scaled);
-        return;
-    }
-
-    // --- Fit: teljes kép látszik (contain, letterbox), oldalarány MEGŐRZÉS ---
-    if (m_aspectMode == Fit) // VideoTile::Fit
-    {
-        p.fillRect(target, Qt::black);
-        QImage scaled = m_frame.scaled(target.size(),
-                                       Qt::KeepAspectRatio,
-                                       Qt::SmoothTransformation);
-        const QPoint topLeft(target.center() - QPoint(scaled.width() / 2, scaled.height() / 2));
-        p.drawImage(QRect(topLeft, scaled.size()), scaled);
-        return;
-    }
-
-    // --- Fill: csempe teljes kitöltése (cover), oldalarány MEGŐRZÉS, szükség szerint vágás ---
-    if (m_aspectMode == Fill) // VideoTile::Fill
-    {
-        const double sw = m_frame.width();
-        const double sh = m_frame.height();
-        const double dw = target.width();
-        const double dh = target.height();
-
-        const double sAspect = sw / sh;
-        const double dAspect = dw / dh;
-
-        QRectF src;
-        if (sAspect > dAspect)
-        {
-            // Forrás szélesebb: magasság kitölt, szélességből vágunk
-            const double newW = sh * dAspect;
-            const double x = (sw - newW) / 2.0;
-            src = QRectF(x, 0, newW, sh);
-        }
-        else
-        {
-            // Forrás magasabb: szélesség kitölt, magasságból vágunk
-            const double newH = sw / dAspect;
-            const double y = (sh - newH) / 2.0;
-            src = QRectF(0, y, sw, newH);
-        }
+    // a kép már célméretű (Fit: oldalarányos, Stretch/Fill: teljes csempe) – középre, skálázás nélkül
+    const QSizeF logical = QSizeF(img.size()) / img.devicePixelRatio();
+    const QPointF topLeft(qRound((target.width() - logical.width()) / 2.0),
+                          qRound((target.height() - logical.height()) / 2.0));
+    const QRectF drawn(topLeft, logical);
 
+    // fekete sáv csak ott kell, ahol a kép nem fed (Fit letterbox)
+    if (!drawn.toAlignedRect().contains(target))
         p.fillRect(target, Qt::black);
-        p.drawImage(target, m_frame, src);
-        return;
-    }
-
-    // Biztonsági ág (ha valamiért ismeretlen mód jut ide): viselkedjünk "Fit"-ként
-    p.fillRect(target, Qt::black);
-    QImage scaled = m_frame.scaled(target.size(),
-                                   Qt::KeepAspectRatio,
-                                   Qt::SmoothTransformation);
-    const QPoint topLeft(target.center() - QPoint(scaled.width() / 2, scaled.height() / 2));
-    p.drawImage(QRect(topLeft, scaled.size()), scaled);
+    p.drawImage(topLeft, img);
+    paintHud(p);
 }
 
 void VideoTile::resizeEvent(QResizeEvent *e)
 {
     QWidget::resizeEvent(e);
     updateHudGeometry();
+    updateConverterTarget(); // a következő frame már az új méretben érkezik
     update();
 }
 
+void VideoTile::showEvent(QShowEvent *e)
+{
+    QWidget::showEvent(e);
+    updateConverterTarget(); // másik képernyőn más lehet a devicePixelRatio
+}
+
 void VideoTile::mouseDoubleClickEvent(QMouseEvent *ev)
 {
     if (ev->button() == Qt::LeftButton)
@@ -364,59 +847,91 @@ void VideoTile::mouseDoubleClickEvent(QMouseEvent *ev)
     QWidget::mouseDoubleClickEvent(ev);
 }
 
-void VideoTile::onZoomClicked()
+void VideoTile::mousePressEvent(QMouseEvent *ev)
 {
-    emit fullscreenRequested();
+    m_zoomPressed = (ev->button() == Qt::LeftButton && m_zoomRect.contains(ev->position().toPoint()));
+    if (m_zoomPressed)
+        ev->accept(); // a felengedés is ide jöjjön
+    else
+        QWidget::mousePressEvent(ev);
 }
 
-// --- státusz segédek ---
-void VideoTile::setStatusConnecting()
+void VideoTile::mouseReleaseEvent(QMouseEvent *ev)
 {
-    if (m_statusDot)
-        m_statusDot->setStyleSheet("background:#ffca28; border-radius:5px;"); // amber/sárga
+    // a festett nagyítás gomb: lenyomás és felengedés is a gombon
+    const bool clicked = m_zoomPressed && ev->button() == Qt::LeftButton &&
+                         m_zoomRect.contains(ev->position().toPoint());
+    m_zoomPressed = false;
+    QWidget::mouseReleaseEvent(ev);
+    if (clicked)
+        emit fullscreenRequested();
 }
-void VideoTile::setStatusOk()
+
+void VideoTile::mouseMoveEvent(QMouseEvent *ev)
 {
-    if (m_statusDot)
-        m_statusDot->setStyleSheet("background:#4caf50; border-radius:5px;"); // zöld
+    setZoomHover(m_zoomRect.contains(ev->position().toPoint()));
+    QWidget::mouseMoveEvent(ev);
 }
-void VideoTile::setStatusError()
+
+void VideoTile::leaveEvent(QEvent *e)
 {
-    if (m_statusDot)
-        m_statusDot->setStyleSheet("background:#f44336; border-radius:5px;"); // piros
+    setZoomHover(false);
+    QWidget::leaveEvent(e);
 }
-void VideoTile::recreatePipeline()
+
+void VideoTile::setZoomHover(bool on)
 {
-    qDebug() << "[VideoTile] recreatePipeline() – rebuilding player and sink";
+    if (m_zoomHover == on)
+        return;
+    m_zoomHover = on;
+    if (on)
+        setCursor(Qt::PointingHandCursor);
+    else
+        unsetCursor();
+    update(m_zoomRect);
+}
 
-    // régi objektumok törlése
-    if (m_player)
+void VideoTile::changeEvent(QEvent *e)
+{
+    QWidget::changeEvent(e);
+    if (e->type() == QEvent::FontChange || e->type() == QEvent::StyleChange)
     {
-        m_player->stop();
-        m_player->setVideoSink(nullptr);
-        m_player->deleteLater();
+        invalidateHud();
+        update();
     }
-    if (m_sink)
+}
+
+bool VideoTile::event(QEvent *e)
+{
+    if (e->type() == QEvent::ToolTip)
     {
-        m_sink->deleteLater();
+        auto *he = static_cast<QHelpEvent *>(e);
+        if (m_zoomRect.contains(he->pos()))
+        {
+            QToolTip::showText(he->globalPos(), Language::instance().t("menu.zoom", "Zoom IN/OUT"), this, m_zoomRect);
+            return true;
+        }
+        // máshol a csempe saját (setToolTip) szövege, pl. hiányzó profil vagy feloldás alatt
     }
-
-    // újak létrehozása
-    m_player = new QMediaPlayer(this);
-    m_sink = new QVideoSink(this);
-    m_player->setVideoSink(m_sink);
-
-    // jelek visszakötése
-    connect(m_sink, &QVideoSink::videoFrameChanged, this, &VideoTile::onVideoFrameChanged);
-    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &VideoTile::onMediaStatusChanged);
-    connect(m_player, &QMediaPlayer::errorOccurred, this, &VideoTile::onErrorOccurred);
-    connect(m_player, &QMediaPlayer::playbackStateChanged, this, &VideoTile::onPlaybackStateChanged);
+    return QWidget::event(e);
 }
+
 void VideoTile::setAspectMode(VideoTile::AspectMode m)
 {
     if (m_aspectMode == m)
         return;
     m_aspectMode = m;
     qDebug() << "[VideoTile] setAspectMode =" << static_cast<int>(m_aspectMode);
+    updateConverterTarget();
     update(); // újrarajzolás
-}
\ No newline at end of file
+}
+
+void VideoTile::setViewport(const QRectF &normalized)
+{
+    const QRectF vp = normalized.intersected(QRectF(0.0, 0.0, 1.0, 1.0));
+    const QRectF next = vp.isEmpty() ? QRectF(0.0, 0.0, 1.0, 1.0) : vp;
+    if (next == m_viewport)
+        return;
+    m_viewport = next;
+    updateConverterTarget(); // a következő frame-től csak ez a rész konvertálódik
+}
@@ -3,14 +3,17 @@
 #include <QImage>
 #include <QUrl>
 #include <QtMultimedia/QMediaPlayer>
-#include <QtMultimedia/QVideoSink>
-#include <QLabel>
-#include <QPushButton>
+#include <QPixmap>
 #include <QTimer>
+#include <QElapsedTimer>
 #include "language.h"
+#include "frameconverter.h"
+#include "wallcompositor.h"
 
 // előre deklaráció, hogy a headerben ne kelljen QVideoFrame-et includolni
 class QVideoFrame;
+class QPainter;
+class StreamSource;
 
 class VideoTile : public QWidget
 {
@@ -24,10 +27,43 @@ public:
     };
     Q_ENUM(AspectMode)
 
-    explicit VideoTile(bool limitFps15, QWidget *parent = nullptr);
+    // csempe-állapot (a HUD pöttyének színe); csak változáskor frissül
+    enum Status
+    {
+        Error = 0,      // piros: nincs stream / hiba
+        Connecting = 1, // sárga: kapcsolódás, újrapróbálás
+        Ok = 2,         // zöld: érkezik kép
+        Stalled = 3     // narancs: kapcsolódva, de a frame-ek elakadtak (watchdog)
+    };
+    Q_ENUM(Status)
+
+    // háttérbe került csempe (pl. fókusz nézet alatt) terhelésének csökkentése
+    enum SuspendLevel
+    {
+        Active = 0,      // normál működés
+        SkipConvert = 1, // az RTSP kapcsolat él, de a frame-ek konverzió/festés nélkül eldobódnak
+        Stopped = 2      // a stream leáll; folytatáskor újrakapcsolódik
+    };
+    Q_ENUM(SuspendLevel)
+
+    // CPU-keret szerinti minőségi szint (QualityScheduler); a fókusz csempe mindig FullQuality
+    enum QualityTier
+    {
+        FullQuality = 0,  // a kamera / rács szerinti FPS
+        ReducedFps = 1,   // alacsonyabb FPS-plafon
+        SubStream = 2,    // + a legkisebb profil (ahol választható)
+        KeyframeOnly = 3  // + ~1 FPS; libav háttérnél skip_frame=nokey (QMediaPlayer-rel nem hagyható ki a dekódolás)
+    };
+    Q_ENUM(QualityTier)
+
+    // maxFps: képkocka-korlát (0 = nincs korlát)
+    explicit VideoTile(double maxFps, QWidget *parent = nullptr);
+    ~VideoTile() override;
 
     void setName(const QString &n);
     void playUrl(const QUrl &url);
+    QUrl url() const { return m_url; }
+    bool hasFrame() const { return m_hasFrame; }
     void stop();
 
     void setAspectMode(AspectMode m);
@@ -36,59 +72,204 @@ public:
     // VISSZAFELÉ KOMPATIBILITÁS (ha bárhol még hívod):
     void setAspectFill(bool on) { setAspectMode(on ? Fill : Fit); }
 
+    // a forrás látható része normalizálva (0..1) – csak ez kerül konvertálásra (digitális zoom)
+    void setViewport(const QRectF &normalized);
+    QRectF viewport() const { return m_viewport; }
+
+    // felfüggesztés / folytatás; SkipConvert-ből azonnali, Stopped-ból újrakapcsolódással
+    void setSuspendLevel(SuspendLevel level);
+    SuspendLevel suspendLevel() const { return m_suspend; }
+
+    // kapcsolódási sorban az elsőbbség (nagyobb = előbb): fókusz > látható > háttér
+    void setAdmissionPriority(int p) { m_admissionPriority = p; }
+    int admissionPriority() const { return m_admissionPriority; }
+
+    // playUrl()-től az első érvényes frame-ig eltelt idő (ms); -1 = még nem jött frame
+    qint64 lastTimeToFirstFrameMs() const { return m_ttffLastMs; }
+    qint64 bestTimeToFirstFrameMs() const { return m_ttffBestMs; }
+    qint64 worstTimeToFirstFrameMs() const { return m_ttffWorstMs; }
+
+    // frame-érkezés figyelése (StreamWatchdog): utolsó frame óta eltelt idő, várható frame-távolság
+    bool watchdogEligible() const { return m_wantPlay && m_suspend != Stopped && m_lastFrameClock.isValid(); }
+    qint64 msSinceLastFrame() const { return m_lastFrameClock.isValid() ? m_lastFrameClock.elapsed() : -1; }
+    double expectedFrameIntervalMs() const { return m_frameIntervalMs; }
+    quint64 stallsDetected() const { return m_stallsDetected; }
+    quint64 watchdogRestarts() const { return m_watchdogRestarts; }
+
+    // make-before-break: újrakapcsolódáskor az új stream a régi mellett nyílik, a csere az első
+    // képén történik, addig az utolsó kép (elavultként jelölve) látszik; ki: bontás + 400 ms szünet
+    void setMakeBeforeBreak(bool on) { m_makeBeforeBreak = on; }
+    bool makeBeforeBreak() const { return m_makeBeforeBreak; }
+
+    // forrás-háttér (StreamSource::Backend) és FFmpeg-opciók; a következő kapcsolódástól érvényes
+    void setStreamBackend(int backend, const QString &avOptions)
+    {
+        m_backend = backend;
+        m_avOptions = avOptions;
+    }
+
+    // FPS-korlát élőben állítható, a stream újraindítása nélkül (0 = nincs korlát)
+    void setMaxFps(double fps);
+    double maxFps() const { return m_maxFps; }
+
+    // minőségi szint + a hozzá tartozó FPS-plafon (0 = nincs); a tényleges korlát a kettő közül a kisebb
+    void setQualityTier(QualityTier tier, double fpsCap);
+    QualityTier qualityTier() const { return m_qualityTier; }
+    double effectiveMaxFps() const;
+    // a fal állítja: van-e kisebb profil, amire a SubStream szint válthat (automatikus ONVIF profil)
+    void setSubStreamAvailable(bool on) { m_subStreamAvailable = on; }
+    // csökkenti-e a szint a dekódolás költségét ennél a csempénél (a QualityScheduler a hatástalant átugorja)
+    bool tierLowersDecode(QualityTier tier) const;
+
+    // közös újrarajzolás-ütemező; nullptr = minden frame-re azonnali update()
+    void setCompositor(WallCompositor *c) { m_compositor = c; }
+
+    // konverziós számlálók (statisztikához)
+    QString name() const { return m_name; }
+    Status status() const { return m_status; }
+    quint64 framesConverted() const;
+    quint64 framesDroppedInMailbox() const;
+    quint64 framesDroppedUnpainted() const;
+    quint64 framesSkippedByFps() const { return m_framesSkippedByFps; }
+    quint64 framesSkippedSuspended() const { return m_framesSkippedSuspended; }
+    // költségbecsléshez: érkezett frame-ek, az utolsó forrás-frame mérete, konverziós idő
+    quint64 framesArrived() const { return m_framesArrived; }
+    qint64 sourcePixels() const { return m_sourcePixels; }
+    quint64 convertNanos() const;
+
 signals:
     void fullscreenRequested(); // gomb vagy dupla katt
+    void firstFrameReady();     // (újra)kapcsolódás után az első kirajzolható kép
+    void connectFailing(int consecutiveFailures); // kapcsolódási hiba (az ütemező számolja)
+    void qualityTierChanged(int tier);
 
 protected:
     void paintEvent(QPaintEvent *) override;
     void resizeEvent(QResizeEvent *) override;
+    void showEvent(QShowEvent *) override;
     void mouseDoubleClickEvent(QMouseEvent *) override;
+    void mousePressEvent(QMouseEvent *) override;
+    void mouseReleaseEvent(QMouseEvent *) override;
+    void mouseMoveEvent(QMouseEvent *) override;
+    void leaveEvent(QEvent *) override;
+    void changeEvent(QEvent *) override;
+    bool event(QEvent *) override; // tooltip a festett nagyítás gombhoz
 
 private slots:
-    void onVideoFrameChanged(const QVideoFrame &frame);
-    void onMediaStatusChanged(QMediaPlayer::MediaStatus st);
-    void onErrorOccurred(QMediaPlayer::Error err, const QString &msg);
-    void onPlaybackStateChanged(QMediaPlayer::PlaybackState st);
-    void onZoomClicked();
-    void retryOnce();
-    void updateTranslations();
+    void onConvertedImageReady();
+
+private:
+    // forrás-események; a jelek forrásonként kötve, hogy a régi és az épülő kapcsolat megkülönböztethető legyen
+    void onSourceFrame(StreamSource *src, const QVideoFrame &frame);
+    void onMediaStatusChanged(StreamSource *src, QMediaPlayer::MediaStatus st);
+    void onErrorOccurred(StreamSource *src, QMediaPlayer::Error err, const QString &msg);
+    void onPlaybackStateChanged(StreamSource *src, QMediaPlayer::PlaybackState st);
+    enum SourceFailure
+    {
+        IgnoredFailure, // egy épp lecserélt forrás hibája, nem számít
+        PendingFailed,  // az épülő kapcsolat bukott el, a régi tovább ad képet
+        SourceFailed    // nincs működő forrás: hiba + újrapróba
+    };
+    SourceFailure acceptSourceFailure(StreamSource *src);
+    void requeuePending(); // csak az új kapcsolatot ütemezi újra, az állapot nem változik
+    void swapInPending();  // az új kapcsolat lesz az aktív, a régi aszinkron bomlik
+    void releaseSources();
 
 private:
-    void rebuildUi();         // overlay gombok, név, státusz
-    void updateHudGeometry(); // overlay elemek pozícionálása
-    void setStatusConnecting();
-    void setStatusOk();
-    void setStatusError();
+    friend class ReconnectScheduler; // az újrapróbálás ütemezése központi
+    friend class StreamWatchdog;     // befagyott stream jelzése
+    void retryOnce();           // backoff lejárt: bontás, majd sorba állás kézfogásra
+    void beginConnectAttempt(); // az ütemező engedélyezte: setSource + play
+    void onWatchdogDegraded();  // hosszabb csend: narancs pötty
+    void onWatchdogStall();     // túl hosszú csend: hibának számít, újrakapcsolódás
+
+    void rebuildUi();         // időzítők; a HUD-ot a paintEvent festi, nincs gyerek-widget
+    void updateHudGeometry(); // név-címke és nagyítás gomb téglalapja
+    void setStatus(Status s); // csak változáskor fest újra (a HUD területét)
+    void invalidateHud();     // név/állapot/betű/dpr változott: a pixmapok újraépülnek
+    void paintHud(QPainter &p);
+    QString hudText() const; // név + minőségi szint jelzése
+    const QPixmap &namePlate();
+    const QPixmap &zoomGlyph(bool hover);
+    void setZoomHover(bool on);
     void restartStream();
     void scheduleRetry();
-    void recreatePipeline();
+    bool acceptFrameForFps(const QVideoFrame &frame, double maxFps); // FPS-szabályzó
+    void resetFpsGovernor();
+    ConvertTarget currentTarget() const; // csempe mérete eszköz-pixelben + képarány-mód
+    void updateConverterTarget();
+    const QImage &scaledFrame(const ConvertTarget &t); // cache-elt, célméretű kép
 
 private:
     // lejátszás
-    QMediaPlayer *m_player{};
-    QVideoSink *m_sink{};
+    StreamSource *m_source{};  // képet adó kapcsolat
+    StreamSource *m_pending{}; // épülő kapcsolat (make-before-break), az első frame-jéig
+    bool m_makeBeforeBreak{true};
+    int m_backend{0}; // StreamSource::QtMultimedia
+    QString m_avOptions;
+    bool m_awaitingFirstFrame{true}; // a következő konvertált kép az új kapcsolat első képe
+    QPointer<StreamSource> m_handshakeSource; // kézfogás alatt álló forrás; az első frame-je a siker
+    FrameConverter *m_converter{}; // háttérszálas konverzió
+    QPointer<WallCompositor> m_compositor; // ütemezett, összevont festés
     AspectMode m_aspectMode = Fit; // alapértelmezett
-    AspectMode m_aspectModeRtsp = Fit; // alapértelmezett
+    QRectF m_viewport{0.0, 0.0, 1.0, 1.0};
     // megjelenítés
-    QImage m_frame; // utolsó kép
+    QImage m_frame; // utolsó kép (a konverter már m_frameTarget méretre skálázta)
+    ConvertTarget m_frameTarget;
     bool m_hasFrame{false};
-    bool m_aspectFill{true}; // true: „cover”, false: „contain”
 
-    // overlay (név, státusz, nagyítás gomb)
-    QWidget *m_overlay{};
-    QLabel *m_nameLbl{};
-    QLabel *m_statusDot{};
-    QPushButton *m_zoomBtn{};
+    // átméretezés / módváltás utáni skálázott kép: (frame, célméret, mód) szerint egyszer számoljuk
+    QImage m_scaledCache;
+    qint64 m_scaledCacheKey{0};
+    ConvertTarget m_scaledCacheTarget;
+
+    // HUD (név, státusz, nagyítás gomb) – festve, pixmap-cache-ből
+    Status m_status{Error};
+    QPixmap m_namePlate;     // pötty + név egy képben
+    QPixmap m_zoomGlyph[2];  // [0] normál, [1] hover
+    QRect m_nameRect;
+    QRect m_zoomRect;
+    bool m_zoomHover{false};
+    bool m_zoomPressed{false};
 
     // egyebek
     QString m_name;
-    bool m_limitFps15{true};
+
+    // FPS-szabályzó: a frame időbélyege alapján dob el, még map()/toImage() előtt
+    double m_maxFps{0.0};
+    qint64 m_nextFrameDueUs{-1}; // következő elfogadható időbélyeg (µs)
+    qint64 m_lastFrameTsUs{-1};
+    QElapsedTimer m_fpsClock;    // tartalék óra, ha a frame-nek nincs időbélyege
+    quint64 m_framesSkippedByFps{0};
+
+    // minőségi szint (QualityScheduler) és költség-számlálók
+    QualityTier m_qualityTier{FullQuality};
+    double m_tierFpsCap{0.0};
+    bool m_subStreamAvailable{false};
+    quint64 m_framesArrived{0};
+    qint64 m_sourcePixels{0};
+
+    // kapcsolódás: elsőbbség + első frame ideje
+    int m_admissionPriority{1};
+    QElapsedTimer m_ttffClock; // playUrl() óta; érvénytelen = nem mérünk
+    qint64 m_ttffLastMs{-1};
+    qint64 m_ttffBestMs{-1};
+    qint64 m_ttffWorstMs{-1};
+
+    // frame-érkezés (watchdog): a konverziós/FPS eldobás előtt mérve
+    QElapsedTimer m_lastFrameClock; // érvénytelen = még nem jött frame ebből a kapcsolatból
+    double m_frameIntervalMs{0.0};  // érkezési távolság mozgóátlaga (ms)
+    quint64 m_stallsDetected{0};
+    quint64 m_watchdogRestarts{0};
+
+    // felfüggesztés
+    SuspendLevel m_suspend{Active};
+    bool m_resumeWanted{false}; // Stopped alatt: folytatáskor kell-e lejátszani
+    quint64 m_framesSkippedSuspended{0};
 
     // reconnect/állapot
     QUrl m_url;
     bool m_wantPlay{false};
-    QTimer m_retryTimer; // 5 mp-enként újrapróbál, ha hiba volt
-    int m_retryCount{0}; // egymás utáni kudarcok száma
-    int m_recreateEvery{3}; // ennyi kudarc után teljes újraépítés
-    QTimer m_teardownDelay; // <-- ÚJ: rövid szünet stop után
+    int m_retryCount{0}; // egymás utáni kudarcok száma (időzítés: ReconnectScheduler)
+    QTimer m_teardownDelay; // rövid szünet bontás után (make-before-break módban 0)
 };
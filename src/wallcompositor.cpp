@@ -0,0 +1,91 @@
+#include "wallcompositor.h"
+
+#include <QRegion>
+#include <QDebug>
+
+WallCompositor::WallCompositor(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setTimerType(Qt::PreciseTimer); // egyenletes ütem, ne csússzon 5%-ot
+    connect(&m_timer, &QTimer::timeout, this, &WallCompositor::tick);
+}
+
+void WallCompositor::setRate(int hz)
+{
+    hz = qBound(0, hz, 240);
+    if (hz == m_hz)
+        return;
+    m_hz = hz;
+    qDebug() << "[WallCompositor] rate =" << m_hz << "Hz";
+
+    if (m_hz == 0)
+    {
+        // kikapcsolás: a még várakozókat azonnal kirajzoljuk
+        m_timer.stop();
+        for (const QPointer<QWidget> &w : std::as_const(m_dirty))
+            if (w)
+                w->update();
+        m_dirty.clear();
+        return;
+    }
+    m_timer.setInterval(qMax(1, qRound(1000.0 / m_hz)));
+    if (!m_dirty.isEmpty())
+        m_timer.start();
+}
+
+void WallCompositor::markDirty(QWidget *tile)
+{
+    if (!tile)
+        return;
+    if (m_hz == 0)
+    {
+        tile->update();
+        return;
+    }
+    m_dirty.insert(tile, tile);
+    if (!m_timer.isActive())
+        m_timer.start();
+}
+
+void WallCompositor::forget(QWidget *tile)
+{
+    m_dirty.remove(tile);
+}
+
+void WallCompositor::tick()
+{
+    if (m_dirty.isEmpty())
+    {
+        m_timer.stop(); // üresjárat: nincs több ébredés, amíg új frame nem jön
+        return;
+    }
+
+    // ablakonként egy régió (fókusz / másik fal ablak külön felület)
+    QHash<QWidget *, QRegion> regions;
+    int tiles = 0;
+    for (const QPointer<QWidget> &w : std::as_const(m_dirty))
+    {
+        if (!w || !w->isVisible())
+            continue;
+        QWidget *win = w->window();
+        regions[win] += QRect(w->mapTo(win, QPoint(0, 0)), w->size());
+        ++tiles;
+    }
+    m_dirty.clear();
+    if (tiles == 0)
+        return;
+
+    QElapsedTimer t;
+    t.start();
+    for (auto it = regions.cbegin(); it != regions.cend(); ++it)
+        it.key()->repaint(it.value()); // szinkron: a mért idő a teljes festés + flush
+    const double ms = t.nsecsElapsed() / 1e6;
+
+    ++m_stats.ticks;
+    m_stats.tilesPainted += quint64(tiles);
+    m_stats.lastPaintMs = ms;
+    m_stats.maxPaintMs = qMax(m_stats.maxPaintMs, ms);
+    m_stats.totalPaintMs += ms;
+    m_stats.lastTiles = tiles;
+    m_stats.maxTiles = qMax(m_stats.maxTiles, tiles);
+}
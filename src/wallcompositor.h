@@ -0,0 +1,58 @@
+#pragma once
+#include <QObject>
+#include <QTimer>
+#include <QHash>
+#include <QPointer>
+#include <QWidget>
+#include <QElapsedTimer>
+
+/*
+ * Fal-szintű újrarajzolás-ütemező.
+ * - A csempék nem hívnak update()-et minden beérkező frame-re, csak jelzik (markDirty),
+ *   hogy új képük van.
+ * - Ütemenként (pl. 30/60 Hz) az összes piszkos csempe téglalapja egy régióba kerül, és
+ *   ablakonként EGY szinkron repaint fut: a Qt backing store egyetlen felületként festi és
+ *   egyszerre „flush”-olja az egész rácsot.
+ * - Ha nincs piszkos csempe, az időzítő leáll (üresjáratban nincs ébredés).
+ * - hz = 0: kikapcsolva, a csempe azonnal update()-el (régi viselkedés).
+ */
+class WallCompositor : public QObject
+{
+    Q_OBJECT
+public:
+    struct Stats
+    {
+        quint64 ticks = 0;        // festést végző ütemek
+        quint64 tilesPainted = 0; // összesen frissített csempe
+        double lastPaintMs = 0.0;
+        double maxPaintMs = 0.0;
+        double totalPaintMs = 0.0;
+        int lastTiles = 0;
+        int maxTiles = 0;
+
+        double avgPaintMs() const { return ticks ? totalPaintMs / double(ticks) : 0.0; }
+        double avgTiles() const { return ticks ? double(tilesPainted) / double(ticks) : 0.0; }
+    };
+
+    explicit WallCompositor(QObject *parent = nullptr);
+
+    void setRate(int hz); // 0 = ki
+    int rate() const { return m_hz; }
+    bool isActive() const { return m_hz > 0; }
+
+    // új frame a csempében: a következő ütemben lesz kirajzolva
+    void markDirty(QWidget *tile);
+    void forget(QWidget *tile); // csempe megszűnik
+
+    Stats stats() const { return m_stats; }
+    void resetStats() { m_stats = Stats{}; }
+
+private slots:
+    void tick();
+
+private:
+    int m_hz{0};
+    QTimer m_timer;
+    QHash<QWidget *, QPointer<QWidget>> m_dirty;
+    Stats m_stats;
+};
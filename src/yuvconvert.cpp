@@ -0,0 +1,618 @@
+#include "yuvconvert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define YUV_HAVE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define YUV_HAVE_X86 0
+#endif
+
+// GCC/Clang (MinGW is) csak célattribútummal engedi az AVX2 intrinsiceket -mavx2 nélkül
+#if YUV_HAVE_X86 && (defined(__GNUC__) || defined(__clang__))
+#define YUV_TARGET_SSE2 __attribute__((target("sse2")))
+#define YUV_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define YUV_TARGET_SSE2
+#define YUV_TARGET_AVX2
+#endif
+
+namespace Yuv
+{
+    namespace
+    {
+        // szűrősúlyok: 14 bites fixpont (összegük pontosan 1 << 14)
+        constexpr int kWeightBits = 14;
+        constexpr int kWeightOne = 1 << kWeightBits;
+        // a függőleges menet kimenete 8.6 fixpontos (16 biten elfér: 255 * 64)
+        constexpr int kMidBits = 6;
+        constexpr int kVertShift = kWeightBits - kMidBits;
+        constexpr int kHorzShift = kWeightBits + kMidBits;
+        // YUV→RGB együtthatók 13 bites fixpontban
+        constexpr int kCoefBits = 13;
+
+        struct Coeffs
+        {
+            int16_t yOff, cy, crv, cgu, cgv, cbu;
+        };
+
+        // egy tengely szűrőtáblája: minden célindexhez forrásindexek + súlyok
+        // (a súlyok taps-os lépésközzel, nulla súllyal kiegészítve – a vízszintes menet fix hosszal fut)
+        struct Filter
+        {
+            std::vector<int> first;
+            std::vector<int> count;
+            std::vector<int16_t> weights;
+            int taps = 1;
+            int minIndex = 0;
+            int maxIndex = 0;
+            bool identity = false; // 1:1, egész pixelre igazítva: nincs mit szűrni
+        };
+
+        using VerticalFn = void (*)(const uint8_t *const *rows, const int16_t *w, int taps,
+                                    int width, uint16_t *out);
+        using RgbFn = void (*)(const uint8_t *y, const uint8_t *u, const uint8_t *v,
+                               uint32_t *dst, int n, const Coeffs &c);
+
+        struct Kernels
+        {
+            const char *name;
+            VerticalFn vertical;
+            RgbFn rgb;
+        };
+
+        Coeffs coeffsFor(const ColorInfo &ci)
+        {
+            // Kr/Kb a mátrixból; limitált tartománynál Y 16..235, C 16..240
+            const double kr = (ci.matrix == Matrix::BT709) ? 0.2126 : 0.299;
+            const double kb = (ci.matrix == Matrix::BT709) ? 0.0722 : 0.114;
+            const double kg = 1.0 - kr - kb;
+            const double ys = ci.fullRange ? 1.0 : 255.0 / 219.0;
+            const double cs = ci.fullRange ? 1.0 : 255.0 / 224.0;
+
+            const double crv = 2.0 * (1.0 - kr) * cs;
+            const double cbu = 2.0 * (1.0 - kb) * cs;
+            const double cgu = -2.0 * (1.0 - kb) * kb / kg * cs;
+            const double cgv = -2.0 * (1.0 - kr) * kr / kg * cs;
+
+            auto fx = [](double v)
+            { return int16_t(std::lround(v * (1 << kCoefBits))); };
+
+            Coeffs c;
+            c.yOff = ci.fullRange ? 0 : 16;
+            c.cy = fx(ys);
+            c.crv = fx(crv);
+            c.cgu = fx(cgu);
+            c.cgv = fx(cgv);
+            c.cbu = fx(cbu);
+            return c;
+        }
+
+        // start/len: forrás-tartomány (tört is lehet), planeLen: sík mérete, dn: célméret
+        Filter buildFilter(double start, double len, int planeLen, int dn)
+        {
+            Filter f;
+            f.first.resize(size_t(dn));
+            f.count.resize(size_t(dn));
+            f.minIndex = planeLen - 1;
+            f.maxIndex = 0;
+
+            const double scale = len / dn;
+            std::vector<double> raw; // nyers súlyok egymás után; célindexenként count[i] darab
+            std::vector<int> rawOffset(static_cast<size_t>(dn));
+            raw.reserve(size_t(dn) * size_t(std::max(2.0, std::ceil(scale) + 1.0)));
+            std::vector<double> w;
+
+            for (int i = 0; i < dn; ++i)
+            {
+                w.clear();
+                int first = 0;
+
+                if (scale > 1.0)
+                {
+                    // kicsinyítés: box szűrő – a célpixel által lefedett forrásterület átlaga
+                    const double a = std::clamp(start + i * scale, 0.0, double(planeLen));
+                    const double b = std::clamp(a + scale, 0.0, double(planeLen));
+                    first = std::min(int(std::floor(a)), planeLen - 1);
+                    const int last = std::max(first, std::min(int(std::ceil(b)) - 1, planeLen - 1));
+                    for (int k = first; k <= last; ++k)
+                        w.push_back(std::max(0.0, std::min(b, k + 1.0) - std::max(a, double(k))));
+                }
+                else
+                {
+                    // nagyítás / 1:1: bilineáris, pixelközéppontok szerint igazítva
+                    double c = start + (i + 0.5) * scale - 0.5;
+                    c = std::clamp(c, 0.0, double(planeLen - 1));
+                    first = int(std::floor(c));
+                    const double fr = c - first;
+                    w.push_back(1.0 - fr);
+                    if (fr > 1e-6 && first + 1 < planeLen)
+                        w.push_back(fr);
+                }
+
+                // elhanyagolható szélső súlyok levágása (box-szélek kerekítése)
+                while (w.size() > 1 && w.back() < 1e-6)
+                    w.pop_back();
+                while (w.size() > 1 && w.front() < 1e-6)
+                {
+                    w.erase(w.begin());
+                    ++first;
+                }
+
+                f.first[size_t(i)] = first;
+                f.count[size_t(i)] = int(w.size());
+                rawOffset[size_t(i)] = int(raw.size());
+                raw.insert(raw.end(), w.begin(), w.end());
+                f.taps = std::max(f.taps, int(w.size()));
+                f.minIndex = std::min(f.minIndex, first);
+                f.maxIndex = std::max(f.maxIndex, first + int(w.size()) - 1);
+            }
+
+            // kvantálás úgy, hogy az összeg pontosan kWeightOne legyen
+            f.weights.assign(size_t(dn) * size_t(f.taps), 0);
+            f.identity = true;
+            for (int i = 0; i < dn; ++i)
+            {
+                const double *rw = raw.data() + rawOffset[size_t(i)];
+                const int n = f.count[size_t(i)];
+                double total = 0.0;
+                for (int k = 0; k < n; ++k)
+                    total += rw[k];
+                if (total <= 0.0)
+                    total = 1.0;
+
+                int16_t *q = &f.weights[size_t(i) * size_t(f.taps)];
+                int sum = 0, biggest = 0;
+                for (int k = 0; k < n; ++k)
+                {
+                    q[k] = int16_t(std::lround(rw[k] * kWeightOne / total));
+                    sum += q[k];
+                    if (q[k] > q[biggest])
+                        biggest = k;
+                }
+                q[biggest] = int16_t(q[biggest] + (kWeightOne - sum));
+
+                if (f.count[size_t(i)] != 1 || f.first[size_t(i)] != f.first[0] + i)
+                    f.identity = false;
+            }
+            return f;
+        }
+
+        /* ---- skalár kernelek (referencia; a SIMD változatok bitre azonos eredményt adnak) ---- */
+
+        // [x0, width) tartomány – a SIMD változatok a maradékot ezzel intézik
+        void verticalScalarFrom(const uint8_t *const *rows, const int16_t *w, int taps, int x0, int width, uint16_t *out)
+        {
+            for (int x = x0; x < width; ++x)
+            {
+                int32_t acc = 0;
+                for (int k = 0; k < taps; ++k)
+                    acc += int32_t(w[k]) * rows[k][x];
+                out[x] = uint16_t((acc + (1 << (kVertShift - 1))) >> kVertShift);
+            }
+        }
+
+        void verticalScalar(const uint8_t *const *rows, const int16_t *w, int taps, int width, uint16_t *out)
+        {
+            verticalScalarFrom(rows, w, taps, 0, width, out);
+        }
+
+        inline uint8_t clamp255(int v)
+        {
+            return uint8_t(v < 0 ? 0 : (v > 255 ? 255 : v));
+        }
+
+        inline uint32_t yuvPixel(int y, int u, int v, const Coeffs &c)
+        {
+            const int yt = (y - c.yOff) * c.cy + (1 << (kCoefBits - 1));
+            const int cu = u - 128;
+            const int cv = v - 128;
+            const int r = (yt + c.crv * cv) >> kCoefBits;
+            const int g = (yt + c.cgu * cu + c.cgv * cv) >> kCoefBits;
+            const int b = (yt + c.cbu * cu) >> kCoefBits;
+            return 0xff000000u | (uint32_t(clamp255(r)) << 16) | (uint32_t(clamp255(g)) << 8) | clamp255(b);
+        }
+
+        void rgbScalar(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t *dst, int n, const Coeffs &c)
+        {
+            for (int x = 0; x < n; ++x)
+                dst[x] = yuvPixel(y[x], u[x], v[x], c);
+        }
+
+#if YUV_HAVE_X86
+        /* ---- SSE2 ---- */
+
+        YUV_TARGET_SSE2 inline __m128i pair16(int lo, int hi)
+        {
+            return _mm_set1_epi32(int32_t(uint32_t(uint16_t(lo)) | (uint32_t(uint16_t(hi)) << 16)));
+        }
+
+        YUV_TARGET_SSE2 void verticalSse2From(const uint8_t *const *rows, const int16_t *w, int taps, int x0, int width, uint16_t *out)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i round = _mm_set1_epi32(1 << (kVertShift - 1));
+            int x = x0;
+            for (; x + 8 <= width; x += 8)
+            {
+                __m128i accLo = round, accHi = round;
+                // két sor egyszerre: (a,b) párok × (wa,wb) → madd 32 bitre
+                for (int k = 0; k < taps; k += 2)
+                {
+                    const bool hasB = (k + 1 < taps);
+                    const __m128i wp = pair16(w[k], hasB ? w[k + 1] : 0);
+                    const __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(rows[k] + x)), zero);
+                    const __m128i b = hasB ? _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(rows[k + 1] + x)), zero)
+                                           : zero;
+                    accLo = _mm_add_epi32(accLo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), wp));
+                    accHi = _mm_add_epi32(accHi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), wp));
+                }
+                accLo = _mm_srai_epi32(accLo, kVertShift);
+                accHi = _mm_srai_epi32(accHi, kVertShift);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), _mm_packs_epi32(accLo, accHi));
+            }
+            verticalScalarFrom(rows, w, taps, x, width, out);
+        }
+
+        YUV_TARGET_SSE2 void verticalSse2(const uint8_t *const *rows, const int16_t *w, int taps, int width, uint16_t *out)
+        {
+            verticalSse2From(rows, w, taps, 0, width, out);
+        }
+
+        YUV_TARGET_SSE2 void rgbSse2(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t *dst, int n, const Coeffs &c)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i one = _mm_set1_epi16(1);
+            const __m128i alpha = _mm_set1_epi8(char(0xff));
+            const __m128i yOff = _mm_set1_epi16(c.yOff);
+            const __m128i c128 = _mm_set1_epi16(128);
+            const __m128i cyR = pair16(c.cy, 1 << (kCoefBits - 1)); // (y, 1) · (cy, kerekítés)
+            const __m128i cR = pair16(0, c.crv);                     // (u, v) párok
+            const __m128i cG = pair16(c.cgu, c.cgv);
+            const __m128i cB = pair16(c.cbu, 0);
+
+            int x = 0;
+            for (; x + 8 <= n; x += 8)
+            {
+                const __m128i y16 = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(y + x)), zero), yOff);
+                const __m128i u16 = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + x)), zero), c128);
+                const __m128i v16 = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + x)), zero), c128);
+
+                const __m128i ytLo = _mm_madd_epi16(_mm_unpacklo_epi16(y16, one), cyR);
+                const __m128i ytHi = _mm_madd_epi16(_mm_unpackhi_epi16(y16, one), cyR);
+                const __m128i uvLo = _mm_unpacklo_epi16(u16, v16);
+                const __m128i uvHi = _mm_unpackhi_epi16(u16, v16);
+
+                const __m128i r16 = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(ytLo, _mm_madd_epi16(uvLo, cR)), kCoefBits),
+                                                    _mm_srai_epi32(_mm_add_epi32(ytHi, _mm_madd_epi16(uvHi, cR)), kCoefBits));
+                const __m128i g16 = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(ytLo, _mm_madd_epi16(uvLo, cG)), kCoefBits),
+                                                    _mm_srai_epi32(_mm_add_epi32(ytHi, _mm_madd_epi16(uvHi, cG)), kCoefBits));
+                const __m128i b16 = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(ytLo, _mm_madd_epi16(uvLo, cB)), kCoefBits),
+                                                    _mm_srai_epi32(_mm_add_epi32(ytHi, _mm_madd_epi16(uvHi, cB)), kCoefBits));
+
+                const __m128i r8 = _mm_packus_epi16(r16, r16);
+                const __m128i g8 = _mm_packus_epi16(g16, g16);
+                const __m128i b8 = _mm_packus_epi16(b16, b16);
+
+                // memóriában B,G,R,A (RGB32 little-endian)
+                const __m128i bg = _mm_unpacklo_epi8(b8, g8);
+                const __m128i ra = _mm_unpacklo_epi8(r8, alpha);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm_unpacklo_epi16(bg, ra));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x + 4), _mm_unpackhi_epi16(bg, ra));
+            }
+            if (x < n)
+                rgbScalar(y + x, u + x, v + x, dst + x, n - x, c);
+        }
+
+        /* ---- AVX2 ---- */
+
+        YUV_TARGET_AVX2 void verticalAvx2(const uint8_t *const *rows, const int16_t *w, int taps, int width, uint16_t *out)
+        {
+            const __m256i round = _mm256_set1_epi32(1 << (kVertShift - 1));
+            int x = 0;
+            for (; x + 16 <= width; x += 16)
+            {
+                __m256i accLo = round, accHi = round;
+                for (int k = 0; k < taps; k += 2)
+                {
+                    const bool hasB = (k + 1 < taps);
+                    const __m256i wp = _mm256_broadcastsi128_si256(pair16(w[k], hasB ? w[k + 1] : 0));
+                    const __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[k] + x)));
+                    const __m256i b = hasB ? _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[k + 1] + x)))
+                                           : _mm256_setzero_si256();
+                    // unpack/pack sávonként dolgozik, de a kettő együtt visszaadja az eredeti sorrendet
+                    accLo = _mm256_add_epi32(accLo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), wp));
+                    accHi = _mm256_add_epi32(accHi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), wp));
+                }
+                accLo = _mm256_srai_epi32(accLo, kVertShift);
+                accHi = _mm256_srai_epi32(accHi, kVertShift);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), _mm256_packs_epi32(accLo, accHi));
+            }
+            verticalSse2From(rows, w, taps, x, width, out);
+        }
+
+        YUV_TARGET_AVX2 void rgbAvx2(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t *dst, int n, const Coeffs &c)
+        {
+            const __m256i one = _mm256_set1_epi16(1);
+            const __m256i alpha = _mm256_set1_epi8(char(0xff));
+            const __m256i yOff = _mm256_set1_epi16(c.yOff);
+            const __m256i c128 = _mm256_set1_epi16(128);
+            const __m256i cyR = _mm256_broadcastsi128_si256(pair16(c.cy, 1 << (kCoefBits - 1)));
+            const __m256i cR = _mm256_broadcastsi128_si256(pair16(0, c.crv));
+            const __m256i cG = _mm256_broadcastsi128_si256(pair16(c.cgu, c.cgv));
+            const __m256i cB = _mm256_broadcastsi128_si256(pair16(c.cbu, 0));
+
+            int x = 0;
+            for (; x + 16 <= n; x += 16)
+            {
+                const __m256i y16 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x))), yOff);
+                const __m256i u16 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(u + x))), c128);
+                const __m256i v16 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(v + x))), c128);
+
+                const __m256i ytLo = _mm256_madd_epi16(_mm256_unpacklo_epi16(y16, one), cyR);
+                const __m256i ytHi = _mm256_madd_epi16(_mm256_unpackhi_epi16(y16, one), cyR);
+                const __m256i uvLo = _mm256_unpacklo_epi16(u16, v16);
+                const __m256i uvHi = _mm256_unpackhi_epi16(u16, v16);
+
+                const __m256i r16 = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_add_epi32(ytLo, _mm256_madd_epi16(uvLo, cR)), kCoefBits),
+                                                       _mm256_srai_epi32(_mm256_add_epi32(ytHi, _mm256_madd_epi16(uvHi, cR)), kCoefBits));
+                const __m256i g16 = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_add_epi32(ytLo, _mm256_madd_epi16(uvLo, cG)), kCoefBits),
+                                                       _mm256_srai_epi32(_mm256_add_epi32(ytHi, _mm256_madd_epi16(uvHi, cG)), kCoefBits));
+                const __m256i b16 = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_add_epi32(ytLo, _mm256_madd_epi16(uvLo, cB)), kCoefBits),
+                                                       _mm256_srai_epi32(_mm256_add_epi32(ytHi, _mm256_madd_epi16(uvHi, cB)), kCoefBits));
+
+                // sávonként: [0..7 | 8..15] bájtok az alsó felekben
+                const __m256i r8 = _mm256_packus_epi16(r16, r16);
+                const __m256i g8 = _mm256_packus_epi16(g16, g16);
+                const __m256i b8 = _mm256_packus_epi16(b16, b16);
+                const __m256i bg = _mm256_unpacklo_epi8(b8, g8);
+                const __m256i ra = _mm256_unpacklo_epi8(r8, alpha);
+                const __m256i lo = _mm256_unpacklo_epi16(bg, ra); // 0..3 | 8..11
+                const __m256i hi = _mm256_unpackhi_epi16(bg, ra); // 4..7 | 12..15
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x), _mm256_permute2x128_si256(lo, hi, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+            }
+            if (x < n)
+                rgbSse2(y + x, u + x, v + x, dst + x, n - x, c);
+        }
+
+        bool cpuHasAvx2()
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int r[4];
+            __cpuid(r, 0);
+            if (r[0] < 7)
+                return false;
+            __cpuid(r, 1);
+            const bool osxsave = (r[2] & (1 << 27)) != 0;
+            const bool avx = (r[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx)
+                return false;
+            if ((_xgetbv(0) & 6) != 6) // YMM állapotot menti-e az OS
+                return false;
+            __cpuidex(r, 7, 0);
+            return (r[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#endif // YUV_HAVE_X86
+
+        const Kernels kScalar{"scalar", verticalScalar, rgbScalar};
+#if YUV_HAVE_X86
+        const Kernels kSse2{"sse2", verticalSse2, rgbSse2};
+        const Kernels kAvx2{"avx2", verticalAvx2, rgbAvx2};
+#endif
+
+        const Kernels *detectKernels()
+        {
+            // CAMERAWALL_SIMD=scalar|sse2|avx2 – hibakereséshez, méréshez
+            const char *env = std::getenv("CAMERAWALL_SIMD");
+            const std::string want = env ? env : "";
+#if YUV_HAVE_X86
+            const bool avx2 = cpuHasAvx2();
+            if (want == "scalar")
+                return &kScalar;
+            if (want == "sse2" || !avx2)
+                return &kSse2; // x86-64-en az SSE2 mindig elérhető
+            return &kAvx2;
+#else
+            (void)want;
+            return &kScalar;
+#endif
+        }
+
+        std::atomic<const Kernels *> gForced{nullptr};
+
+        const Kernels &kernels()
+        {
+            if (const Kernels *f = gForced.load(std::memory_order_acquire))
+                return *f;
+            static const Kernels *k = detectKernels();
+            return *k;
+        }
+
+        void runVertical(const Filter &f, int i, const uint8_t *plane, int stride, int byteOffset,
+                         int width, uint16_t *out, std::vector<const uint8_t *> &rows)
+        {
+            const int n = f.count[size_t(i)];
+            rows.resize(size_t(n));
+            for (int t = 0; t < n; ++t)
+                rows[size_t(t)] = plane + size_t(f.first[size_t(i)] + t) * size_t(stride) + byteOffset;
+            kernels().vertical(rows.data(), &f.weights[size_t(i) * size_t(f.taps)], n, width, out);
+        }
+
+        // vízszintes menet (skalár, fix tap-számmal): step=2 az összefésült NV12 UV sorhoz, phase=0/1 (U/V)
+        template <int Taps>
+        void horizontalFixed(const uint16_t *in, const Filter &f, int step, int phase, uint8_t *out, int dn)
+        {
+            const int16_t *w = f.weights.data();
+            for (int i = 0; i < dn; ++i, w += Taps)
+            {
+                const uint16_t *src = in + size_t(f.first[size_t(i)] - f.minIndex) * step + phase;
+                int32_t acc = 0;
+                for (int k = 0; k < Taps; ++k)
+                    acc += int32_t(w[k]) * src[k * step];
+                const int v = (acc + (1 << (kHorzShift - 1))) >> kHorzShift;
+                out[i] = uint8_t(v > 255 ? 255 : v);
+            }
+        }
+
+        void runHorizontal(const uint16_t *in, const Filter &f, int step, int phase, uint8_t *out, int dn)
+        {
+            switch (f.taps)
+            {
+            case 1:
+                return horizontalFixed<1>(in, f, step, phase, out, dn);
+            case 2:
+                return horizontalFixed<2>(in, f, step, phase, out, dn);
+            case 3:
+                return horizontalFixed<3>(in, f, step, phase, out, dn);
+            case 4:
+                return horizontalFixed<4>(in, f, step, phase, out, dn);
+            default:
+                break;
+            }
+            // a paddingelt nulla súlyok a sor végén túlmutathatnak: csak count-ig olvasunk
+            for (int i = 0; i < dn; ++i)
+            {
+                const int16_t *w = &f.weights[size_t(i) * size_t(f.taps)];
+                const uint16_t *src = in + size_t(f.first[size_t(i)] - f.minIndex) * step + phase;
+                int32_t acc = 0;
+                for (int k = 0; k < f.count[size_t(i)]; ++k)
+                    acc += int32_t(w[k]) * src[k * step];
+                const int v = (acc + (1 << (kHorzShift - 1))) >> kHorzShift;
+                out[i] = uint8_t(v > 255 ? 255 : v);
+            }
+        }
+    } // namespace
+
+    const char *activeKernel()
+    {
+        return kernels().name;
+    }
+
+    bool forceKernel(const char *name)
+    {
+        const std::string n = name ? name : "";
+        if (n == "scalar")
+        {
+            gForced.store(&kScalar, std::memory_order_release);
+            return true;
+        }
+#if YUV_HAVE_X86
+        if (n == "sse2")
+        {
+            gForced.store(&kSse2, std::memory_order_release);
+            return true;
+        }
+        if (n == "avx2" && cpuHasAvx2())
+        {
+            gForced.store(&kAvx2, std::memory_order_release);
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    bool convertScaled(const Planes &src, const ColorInfo &color, const SourceRect &regionIn,
+                       uint32_t *dst, int dstStride, int dstW, int dstH)
+    {
+        if (!dst || dstW <= 0 || dstH <= 0 || src.width <= 1 || src.height <= 1 || !src.y || !src.u)
+            return false;
+        if (src.layout == Layout::I420 && !src.v)
+            return false;
+
+        // forrás-téglalap a képre vágva; üres → teljes kép
+        SourceRect r = regionIn;
+        if (r.w <= 0 || r.h <= 0)
+            r = SourceRect{0, 0, double(src.width), double(src.height)};
+        r.x = std::clamp(r.x, 0.0, double(src.width - 1));
+        r.y = std::clamp(r.y, 0.0, double(src.height - 1));
+        r.w = std::clamp(r.w, 1.0, src.width - r.x);
+        r.h = std::clamp(r.h, 1.0, src.height - r.y);
+
+        const int cw = (src.width + 1) / 2;
+        const int ch = (src.height + 1) / 2;
+
+        const Filter fx = buildFilter(r.x, r.w, src.width, dstW);
+        const Filter fy = buildFilter(r.y, r.h, src.height, dstH);
+        const Filter cx = buildFilter(r.x / 2.0, r.w / 2.0, cw, dstW);
+        const Filter cy = buildFilter(r.y / 2.0, r.h / 2.0, ch, dstH);
+
+        const Coeffs coeffs = coeffsFor(color);
+        const bool nv12 = (src.layout == Layout::NV12);
+
+        // csak a ténylegesen használt oszlopokat szűrjük függőlegesen
+        const int lumaW = fx.maxIndex - fx.minIndex + 1;
+        const int chromaW = cx.maxIndex - cx.minIndex + 1;
+
+        // a vízszintes menet fix tap-számmal olvas: a nulla súlyú kiegészítés miatt némi ráhagyás kell
+        std::vector<uint16_t> midY(static_cast<size_t>(lumaW + fx.taps));
+        std::vector<uint16_t> midU(static_cast<size_t>(chromaW + cx.taps) * (nv12 ? 2 : 1));
+        std::vector<uint16_t> midV(nv12 ? 0 : static_cast<size_t>(chromaW + cx.taps));
+        std::vector<uint8_t> rowY(static_cast<size_t>(dstW));
+        std::vector<uint8_t> rowU(static_cast<size_t>(dstW));
+        std::vector<uint8_t> rowV(static_cast<size_t>(dstW));
+        std::vector<const uint8_t *> rows;
+        rows.reserve(size_t(std::max(fy.taps, cy.taps)));
+
+        uint8_t *outU = src.swapUV ? rowV.data() : rowU.data();
+        uint8_t *outV = src.swapUV ? rowU.data() : rowV.data();
+
+        // 1:1 luma (pl. teljes felbontás, vagy vágás skálázás nélkül): a sík sorai közvetlenül mennek
+        const bool lumaDirect = fx.identity && fy.identity;
+
+        for (int dy = 0; dy < dstH; ++dy)
+        {
+            const uint8_t *lumaRow = nullptr;
+            if (lumaDirect)
+            {
+                lumaRow = src.y + size_t(fy.first[size_t(dy)]) * size_t(src.yStride) + fx.first[0];
+            }
+            else
+            {
+                runVertical(fy, dy, src.y, src.yStride, fx.minIndex, lumaW, midY.data(), rows);
+                runHorizontal(midY.data(), fx, 1, 0, rowY.data(), dstW);
+                lumaRow = rowY.data();
+            }
+
+            // egymást követő célsorok gyakran ugyanazt a chroma-sort kapják (4:2:0): csak akkor számolunk, ha változott
+            const bool sameChroma = dy > 0 && cy.first[size_t(dy)] == cy.first[size_t(dy - 1)] &&
+                                    std::equal(&cy.weights[size_t(dy) * size_t(cy.taps)],
+                                               &cy.weights[size_t(dy) * size_t(cy.taps)] + cy.taps,
+                                               &cy.weights[size_t(dy - 1) * size_t(cy.taps)]);
+            if (!sameChroma)
+            {
+                if (nv12)
+                {
+                    runVertical(cy, dy, src.u, src.uStride, cx.minIndex * 2, chromaW * 2, midU.data(), rows);
+                    runHorizontal(midU.data(), cx, 2, 0, outU, dstW);
+                    runHorizontal(midU.data(), cx, 2, 1, outV, dstW);
+                }
+                else
+                {
+                    runVertical(cy, dy, src.u, src.uStride, cx.minIndex, chromaW, midU.data(), rows);
+                    runVertical(cy, dy, src.v, src.vStride, cx.minIndex, chromaW, midV.data(), rows);
+                    runHorizontal(midU.data(), cx, 1, 0, outU, dstW);
+                    runHorizontal(midV.data(), cx, 1, 0, outV, dstW);
+                }
+            }
+
+            auto *line = reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(dst) + size_t(dy) * size_t(dstStride));
+            kernels().rgb(lumaRow, rowU.data(), rowV.data(), line, dstW, coeffs);
+        }
+        return true;
+    }
+
+} // namespace Yuv
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+
+/*
+ * YUV 4:2:0 → RGB32 konverzió skálázással, EGY menetben.
+ * - Bemenet: I420 (YUV420P / YUVJ420P, YV12) vagy NV12/NV21 síkok.
+ * - A forrásnak csak a megadott téglalapja (crop) kerül feldolgozásra.
+ * - Kicsinyítésnél „box” (területátlag), nagyításnál bilineáris szűrő.
+ * - A kernelek (függőleges szűrés, YUV→RGB) SSE2/AVX2-vel futnak, ha a CPU tudja,
+ *   különben skalár változat; a választás futásidőben, egyszer történik.
+ * Qt-független, hogy a konverter worker szálán bármilyen kontextusban hívható legyen.
+ */
+namespace Yuv
+{
+    enum class Layout
+    {
+        I420, // három külön sík: Y, U, V
+        NV12  // Y + összefésült UV sík (NV21-nél a hívó cseréli a sorrendet: swapUV)
+    };
+
+    enum class Matrix
+    {
+        BT601,
+        BT709
+    };
+
+    struct Planes
+    {
+        Layout layout = Layout::I420;
+        int width = 0, height = 0; // luma méret
+        const uint8_t *y = nullptr;
+        int yStride = 0;
+        const uint8_t *u = nullptr; // NV12: az UV sík
+        int uStride = 0;
+        const uint8_t *v = nullptr; // csak I420
+        int vStride = 0;
+        bool swapUV = false;        // NV21 / YV12
+    };
+
+    struct ColorInfo
+    {
+        Matrix matrix = Matrix::BT601;
+        bool fullRange = false; // YUVJ (JPEG) tartomány: Y 0..255
+    };
+
+    // forrás-téglalap luma pixelben (lehet tört is, pl. Fill-vágásnál)
+    struct SourceRect
+    {
+        double x = 0, y = 0, w = 0, h = 0;
+    };
+
+    // dst: 0xffRRGGBB pixelek (QImage::Format_RGB32), dstStride bájtban
+    bool convertScaled(const Planes &src, const ColorInfo &color, const SourceRect &region,
+                       uint32_t *dst, int dstStride, int dstW, int dstH);
+
+    // a futásidőben kiválasztott kernel neve ("avx2", "sse2", "scalar") – naplózáshoz
+    const char *activeKernel();
+
+    // teszteléshez/méréshez: kernel kényszerítése ("scalar", "sse2", "avx2"); false, ha nem elérhető
+    bool forceKernel(const char *name);
+
+} // namespace Yuv
@@ -0,0 +1,150 @@
+#include "onvifdiscovery.h"
+
+#include <QtTest/QtTest>
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+#include <QRegularExpression>
+#include <QUuid>
+
+/*
+ * WS-Discovery keresés helyi (loopback) válaszolóval: a próba célja egy 127.0.0.1-es
+ * QUdpSocket, amely a próba MessageID-jára ProbeMatch-et küld vissza (egy eszközt kétszer is,
+ * és egy idegen RelatesTo-val érkező választ). A profil-lekérés ki van kapcsolva.
+ */
+class TestOnvifDiscovery : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseProbeMatches();
+    void parseRejectsForeignRelatesTo();
+    void loopbackProbe();
+};
+
+namespace
+{
+    QByteArray probeMatch(const QString &relatesTo, const QStringList &endpoints, const QString &xaddrHost)
+    {
+        QString matches;
+        int n = 0;
+        for (const QString &ep : endpoints)
+        {
+            matches += QStringLiteral(R"(
+      <d:ProbeMatch>
+        <w:EndpointReference><w:Address>%1</w:Address></w:EndpointReference>
+        <d:Types>dn:NetworkVideoTransmitter</d:Types>
+        <d:Scopes>onvif://www.onvif.org/name/Cam_%2 onvif://www.onvif.org/hardware/HW-%2 onvif://www.onvif.org/type/video_encoder</d:Scopes>
+        <d:XAddrs>http://%3:80%2/onvif/device_service</d:XAddrs>
+        <d:MetadataVersion>1</d:MetadataVersion>
+      </d:ProbeMatch>)")
+                           .arg(ep)
+                           .arg(++n)
+                           .arg(xaddrHost);
+        }
+        return QStringLiteral(R"(<?xml version="1.0" encoding="UTF-8"?>
+<e:Envelope xmlns:e="http://www.w3.org/2003/05/soap-envelope"
+            xmlns:w="http://schemas.xmlsoap.org/ws/2004/08/addressing"
+            xmlns:d="http://schemas.xmlsoap.org/ws/2005/04/discovery"
+            xmlns:dn="http://www.onvif.org/ver10/network/wsdl">
+  <e:Header>
+    <w:MessageID>uuid:%1</w:MessageID>
+    <w:RelatesTo>%2</w:RelatesTo>
+    <w:Action>http://schemas.xmlsoap.org/ws/2005/04/discovery/ProbeMatches</w:Action>
+  </e:Header>
+  <e:Body>
+    <d:ProbeMatches>%3
+    </d:ProbeMatches>
+  </e:Body>
+</e:Envelope>)")
+            .arg(QUuid::createUuid().toString(QUuid::WithoutBraces), relatesTo, matches)
+            .toUtf8();
+    }
+
+    QString messageIdOf(const QByteArray &probe)
+    {
+        static const QRegularExpression re(QStringLiteral("<w:MessageID>([^<]+)</w:MessageID>"));
+        return re.match(QString::fromUtf8(probe)).captured(1);
+    }
+}
+
+void TestOnvifDiscovery::parseProbeMatches()
+{
+    const QString id = QStringLiteral("uuid:test-1");
+    QList<OnvifDiscovery::Device> out;
+    QVERIFY(OnvifDiscovery::parseProbeMatches(
+        probeMatch(id, {"urn:uuid:aaa", "urn:uuid:bbb"}, "192.168.1.10"), id, out));
+    QCOMPARE(out.size(), 2);
+    QCOMPARE(out[0].endpoint, QStringLiteral("urn:uuid:aaa"));
+    QCOMPARE(out[0].name, QStringLiteral("Cam_1"));
+    QCOMPARE(out[0].hardware, QStringLiteral("HW-1"));
+    QCOMPARE(out[0].xaddrs.size(), 1);
+    QCOMPARE(out[0].deviceXAddr(), QUrl("http://192.168.1.10:801/onvif/device_service"));
+    QCOMPARE(out[1].endpoint, QStringLiteral("urn:uuid:bbb"));
+    QCOMPARE(out[1].scopes.size(), 3);
+
+    // a saját próba üzenete is jól formált, és a MessageID benne van
+    QCOMPARE(messageIdOf(OnvifDiscovery::probeMessage(id)), id);
+}
+
+void TestOnvifDiscovery::parseRejectsForeignRelatesTo()
+{
+    QList<OnvifDiscovery::Device> out;
+    QVERIFY(!OnvifDiscovery::parseProbeMatches(
+        probeMatch("uuid:someone-else", {"urn:uuid:ccc"}, "10.0.0.1"), "uuid:mine", out));
+
+    // hibás XML
+    out.clear();
+    QVERIFY(!OnvifDiscovery::parseProbeMatches("<e:Envelope><broken", "uuid:mine", out));
+}
+
+void TestOnvifDiscovery::loopbackProbe()
+{
+    QUdpSocket responder;
+    QVERIFY(responder.bind(QHostAddress::LocalHost, 0));
+
+    int probes = 0;
+    connect(&responder, &QUdpSocket::readyRead, &responder, [&]
+            {
+        while (responder.hasPendingDatagrams())
+        {
+            const QNetworkDatagram dg = responder.receiveDatagram();
+            const QString id = messageIdOf(dg.data());
+            if (id.isEmpty())
+                continue;
+            ++probes;
+            // ugyanaz az eszköz egy válaszon belül kétszer, majd külön válaszban újra,
+            // plusz egy másik keresésnek szóló válasz, amit figyelmen kívül kell hagyni
+            responder.writeDatagram(probeMatch(id, {"urn:uuid:cam-a", "urn:uuid:cam-a"}, "127.0.0.1"),
+                                    dg.senderAddress(), quint16(dg.senderPort()));
+            responder.writeDatagram(probeMatch(id, {"urn:uuid:cam-a", "urn:uuid:cam-b"}, "127.0.0.1"),
+                                    dg.senderAddress(), quint16(dg.senderPort()));
+            responder.writeDatagram(probeMatch("uuid:foreign-probe", {"urn:uuid:cam-x"}, "127.0.0.1"),
+                                    dg.senderAddress(), quint16(dg.senderPort()));
+        } });
+
+    OnvifDiscovery disc;
+    disc.setProbeTarget(QHostAddress::LocalHost, responder.localPort());
+    disc.setFetchDetails(false);
+
+    QSignalSpy found(&disc, &OnvifDiscovery::deviceFound);
+    QSignalSpy updated(&disc, &OnvifDiscovery::deviceUpdated);
+    QSignalSpy finished(&disc, &OnvifDiscovery::finished);
+
+    QVERIFY(disc.start(800));
+    QVERIFY(disc.isRunning());
+    QVERIFY(finished.wait(5000));
+    QCOMPARE(finished.count(), 1);
+    QVERIFY(!disc.isRunning());
+    QVERIFY(probes >= 1); // a próba (és az ismétlése) megérkezett
+
+    QStringList endpoints;
+    for (const QList<QVariant> &args : std::as_const(found))
+        endpoints << args.at(0).value<OnvifDiscovery::Device>().endpoint;
+    endpoints.sort();
+    QCOMPARE(endpoints, QStringList({"urn:uuid:cam-a", "urn:uuid:cam-b"}));
+    QCOMPARE(disc.devices().size(), 2);
+    QCOMPARE(updated.count(), 0); // profil-lekérés kikapcsolva
+}
+
+QTEST_GUILESS_MAIN(TestOnvifDiscovery)
+#include "tst_onvifdiscovery.moc"
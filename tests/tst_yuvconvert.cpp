@@ -0,0 +1,270 @@
+#include "yuvconvert.h"
+
+#include <QtTest/QtTest>
+#include <QtMultimedia/QVideoFrame>
+#include <QtMultimedia/QVideoFrameFormat>
+#include <QImage>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+/*
+ * A Yuv::convertScaled kernelei (scalar / SSE2 / AVX2) a Qt saját konverziójához mérve:
+ * referencia = QVideoFrame::toImage(), majd QImage-vágás és sima (SmoothTransformation) skálázás.
+ * A szűrők nem bitre azonosak a Qt-éval, ezért lassan változó (lineáris) mintát használunk,
+ * és tűréssel hasonlítunk; a SIMD kernelek a skalártól legfeljebb kerekítésnyit térhetnek el.
+ */
+class TestYuvConvert : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesQt_data();
+    void matchesQt();
+
+private:
+    enum class Kind
+    {
+        NV12,
+        NV21,
+        YUV420P,
+        YV12,
+        YUVJ420P
+    };
+};
+
+namespace
+{
+    // lineáris minta, kis meredekséggel: a szűrő- és a chroma-elhelyezési különbségek így csak néhány szintet adnak
+    int lumaAt(int x, int y, int w, int h)
+    {
+        const double slope = std::min(1.0, 170.0 / (w + h));
+        return std::clamp(int(std::lround(32 + (x + y) * slope)), 16, 235);
+    }
+
+    int chromaAt(int c, int len, bool isV)
+    {
+        const double slope = std::min(1.5, 90.0 / len);
+        const double v = 128 + (c - len / 2.0) * slope * (isV ? -1.0 : 1.0);
+        return std::clamp(int(std::lround(v)), 16, 240);
+    }
+
+    QVideoFrame makeFrame(QVideoFrameFormat::PixelFormat pf, bool fullRange, int w, int h)
+    {
+        QVideoFrameFormat fmt(QSize(w, h), pf);
+        fmt.setColorSpace(QVideoFrameFormat::ColorSpace_BT601);
+        fmt.setColorRange(fullRange ? QVideoFrameFormat::ColorRange_Full : QVideoFrameFormat::ColorRange_Video);
+        QVideoFrame frame(fmt);
+        if (!frame.map(QVideoFrame::WriteOnly))
+            return QVideoFrame();
+
+        const int cw = (w + 1) / 2;
+        const int ch = (h + 1) / 2;
+        for (int y = 0; y < h; ++y)
+        {
+            uchar *row = frame.bits(0) + y * frame.bytesPerLine(0);
+            for (int x = 0; x < w; ++x)
+                row[x] = uchar(lumaAt(x, y, w, h));
+        }
+        // NV21: V, U sorrend az összefésült síkban; YV12: a V sík jön előbb
+        const bool vFirst = (pf == QVideoFrameFormat::Format_NV21 || pf == QVideoFrameFormat::Format_YV12);
+        for (int y = 0; y < ch; ++y)
+        {
+            if (pf == QVideoFrameFormat::Format_NV12 || pf == QVideoFrameFormat::Format_NV21)
+            {
+                uchar *uv = frame.bits(1) + y * frame.bytesPerLine(1);
+                for (int x = 0; x < cw; ++x)
+                {
+                    uv[2 * x + (vFirst ? 1 : 0)] = uchar(chromaAt(x, cw, false));
+                    uv[2 * x + (vFirst ? 0 : 1)] = uchar(chromaAt(y, ch, true));
+                }
+            }
+            else
+            {
+                uchar *u = frame.bits(vFirst ? 2 : 1) + y * frame.bytesPerLine(vFirst ? 2 : 1);
+                uchar *v = frame.bits(vFirst ? 1 : 2) + y * frame.bytesPerLine(vFirst ? 1 : 2);
+                for (int x = 0; x < cw; ++x)
+                {
+                    u[x] = uchar(chromaAt(x, cw, false));
+                    v[x] = uchar(chromaAt(y, ch, true));
+                }
+            }
+        }
+        frame.unmap();
+        return frame;
+    }
+
+    QImage convertWith(const QVideoFrame &in, const QRect &crop, const QSize &dstSize)
+    {
+        QVideoFrame f(in);
+        if (!f.map(QVideoFrame::ReadOnly))
+            return QImage();
+
+        Yuv::Planes p;
+        p.width = f.width();
+        p.height = f.height();
+        p.y = f.bits(0);
+        p.yStride = f.bytesPerLine(0);
+        // ugyanúgy, mint a FrameConverter: YV12-nél a síkok cseréje, NV21-nél swapUV
+        if (f.pixelFormat() == QVideoFrameFormat::Format_NV12 || f.pixelFormat() == QVideoFrameFormat::Format_NV21)
+        {
+            p.layout = Yuv::Layout::NV12;
+            p.u = f.bits(1);
+            p.uStride = f.bytesPerLine(1);
+            p.swapUV = (f.pixelFormat() == QVideoFrameFormat::Format_NV21);
+        }
+        else
+        {
+            const bool yv12 = (f.pixelFormat() == QVideoFrameFormat::Format_YV12);
+            p.layout = Yuv::Layout::I420;
+            p.u = f.bits(yv12 ? 2 : 1);
+            p.uStride = f.bytesPerLine(yv12 ? 2 : 1);
+            p.v = f.bits(yv12 ? 1 : 2);
+            p.vStride = f.bytesPerLine(yv12 ? 1 : 2);
+        }
+        Yuv::ColorInfo ci;
+        ci.matrix = Yuv::Matrix::BT601;
+        ci.fullRange = (f.surfaceFormat().colorRange() == QVideoFrameFormat::ColorRange_Full);
+
+        QImage out(dstSize, QImage::Format_RGB32);
+        const Yuv::SourceRect src{double(crop.x()), double(crop.y()), double(crop.width()), double(crop.height())};
+        const bool ok = Yuv::convertScaled(p, ci, src, reinterpret_cast<uint32_t *>(out.bits()),
+                                           int(out.bytesPerLine()), out.width(), out.height());
+        f.unmap();
+        return ok ? out : QImage();
+    }
+
+    struct Diff
+    {
+        int max = 0;
+        double mean = 0.0;
+    };
+
+    Diff compare(const QImage &a, const QImage &b)
+    {
+        Diff d;
+        qint64 sum = 0;
+        for (int y = 0; y < a.height(); ++y)
+        {
+            const QRgb *ra = reinterpret_cast<const QRgb *>(a.constScanLine(y));
+            const QRgb *rb = reinterpret_cast<const QRgb *>(b.constScanLine(y));
+            for (int x = 0; x < a.width(); ++x)
+            {
+                const int dr = std::abs(qRed(ra[x]) - qRed(rb[x]));
+                const int dg = std::abs(qGreen(ra[x]) - qGreen(rb[x]));
+                const int db = std::abs(qBlue(ra[x]) - qBlue(rb[x]));
+                d.max = std::max({d.max, dr, dg, db});
+                sum += dr + dg + db;
+            }
+        }
+        const qint64 n = qint64(a.width()) * a.height() * 3;
+        d.mean = n ? double(sum) / n : 0.0;
+        return d;
+    }
+}
+
+void TestYuvConvert::matchesQt_data()
+{
+    QTest::addColumn<QString>("kernel");
+    QTest::addColumn<int>("kind");
+    QTest::addColumn<QSize>("srcSize");
+    QTest::addColumn<QRect>("crop");
+    QTest::addColumn<QSize>("dstSize");
+
+    struct Case
+    {
+        const char *name;
+        QSize src;
+        QRect crop; // üres: a teljes kép
+        QSize dst;
+    };
+    const Case cases[] = {
+        {"identity", {64, 48}, {}, {64, 48}},
+        {"box-down", {320, 240}, {}, {80, 60}},
+        {"box-down-fractional", {320, 240}, {}, {97, 71}},
+        {"bilinear-up", {40, 30}, {}, {120, 90}},
+        {"cropped-1to1", {320, 240}, {64, 32, 128, 96}, {128, 96}},
+        {"cropped-down", {320, 240}, {64, 32, 128, 96}, {64, 48}},
+        {"cropped-up", {160, 120}, {40, 20, 40, 30}, {100, 75}},
+        {"odd-identity", {63, 37}, {}, {63, 37}},
+        {"odd-down", {63, 37}, {}, {25, 15}},
+        {"odd-up", {17, 11}, {}, {51, 33}},
+        {"odd-width", {65, 48}, {}, {33, 24}},
+        {"odd-height", {64, 49}, {}, {32, 25}},
+        {"odd-cropped", {63, 37}, {7, 5, 31, 21}, {20, 13}},
+    };
+    const struct
+    {
+        Kind kind;
+        const char *name;
+    } kinds[] = {{Kind::NV12, "nv12"},
+                 {Kind::NV21, "nv21"},
+                 {Kind::YUV420P, "yuv420p"},
+                 {Kind::YV12, "yv12"},
+                 {Kind::YUVJ420P, "yuvj420p"}};
+
+    for (const char *kernel : {"scalar", "sse2", "avx2"})
+        for (const auto &k : kinds)
+            for (const Case &c : cases)
+            {
+                const QRect crop = c.crop.isEmpty() ? QRect(QPoint(0, 0), c.src) : c.crop;
+                QTest::addRow("%s/%s/%s", kernel, k.name, c.name)
+                    << QString::fromLatin1(kernel) << int(k.kind) << c.src << crop << c.dst;
+            }
+}
+
+void TestYuvConvert::matchesQt()
+{
+    QFETCH(QString, kernel);
+    QFETCH(int, kind);
+    QFETCH(QSize, srcSize);
+    QFETCH(QRect, crop);
+    QFETCH(QSize, dstSize);
+
+    QVideoFrameFormat::PixelFormat pf = QVideoFrameFormat::Format_YUV420P;
+    switch (Kind(kind))
+    {
+    case Kind::NV12:
+        pf = QVideoFrameFormat::Format_NV12;
+        break;
+    case Kind::NV21:
+        pf = QVideoFrameFormat::Format_NV21;
+        break;
+    case Kind::YV12:
+        pf = QVideoFrameFormat::Format_YV12;
+        break;
+    case Kind::YUV420P:
+    case Kind::YUVJ420P:
+        break;
+    }
+    const QVideoFrame frame = makeFrame(pf, Kind(kind) == Kind::YUVJ420P, srcSize.width(), srcSize.height());
+    QVERIFY(frame.isValid());
+
+    // referencia: a Qt teljes konverziója, utána vágás és skálázás
+    QImage ref = frame.toImage();
+    QVERIFY(!ref.isNull());
+    ref = ref.convertToFormat(QImage::Format_RGB32).copy(crop);
+    if (ref.size() != dstSize)
+        ref = ref.scaled(dstSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    QVERIFY(Yuv::forceKernel("scalar"));
+    const QImage scalar = convertWith(frame, crop, dstSize);
+    QVERIFY(!scalar.isNull());
+
+    if (!Yuv::forceKernel(kernel.toLatin1().constData()))
+        QSKIP("kernel not available on this CPU");
+    const QImage out = convertWith(frame, crop, dstSize);
+    QVERIFY(!out.isNull());
+    QCOMPARE(out.size(), dstSize);
+
+    // a SIMD út ugyanazt számolja, csak a kerekítés térhet el
+    const Diff vsScalar = compare(out, scalar);
+    QVERIFY2(vsScalar.max <= 1, qPrintable(QStringLiteral("max diff vs scalar: %1").arg(vsScalar.max)));
+
+    const Diff vsQt = compare(out, ref);
+    QVERIFY2(vsQt.max <= 12 && vsQt.mean <= 2.5,
+             qPrintable(QStringLiteral("vs Qt: max %1, mean %2").arg(vsQt.max).arg(vsQt.mean, 0, 'f', 2)));
+}
+
+QTEST_MAIN(TestYuvConvert)
+#include "tst_yuvconvert.moc"